@@ -0,0 +1,61 @@
+#include "AllocCounter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifndef NDEBUG
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+void* countedAllocate(std::size_t size, std::size_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size = size == 0 ? 1 : size;
+    void* pointer = alignment <= alignof(std::max_align_t)
+                        ? std::malloc(size)
+                        : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+} // namespace
+
+// The array and nothrow forms forward to these, so they are counted too
+void* operator new(std::size_t size) {
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+uint64_t heapAllocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+uint64_t heapAllocationCount() {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef ALLOCCOUNTER_HPP
+#define ALLOCCOUNTER_HPP
+
+#include <cstdint>
+
+// Debug builds replace the global operator new to count heap allocations, so
+// tests of steady-state frames can check that none happen. Release builds
+// (NDEBUG) keep the standard allocator and count nothing.
+#ifdef NDEBUG
+constexpr bool kCountsAllocations = false;
+#else
+constexpr bool kCountsAllocations = true;
+#endif
+
+// Function to get the number of heap allocations since the program started (0 without counting)
+uint64_t heapAllocationCount();
+
+#endif // ALLOCCOUNTER_HPP
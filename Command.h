@@ -0,0 +1,24 @@
+#ifndef COMMAND_HPP
+#define COMMAND_HPP
+
+// A single operator/planner command for the arm. Commands are produced outside
+// the simulation loop (console thread, IPC, ...) and applied at the next tick.
+struct ArmCommand {
+    enum class Type {
+        Target,     // a, b: target in pixel coordinates
+        TargetGrid, // a, b: target in grid units relative to the pivot (+y is up)
+        Lengths,    // a, b: new L1 and L2
+        Pivot,      // a, b: new zero point (px, py)
+        Item,       // a, b: place an item at this pixel position
+        Track,      // a, b: end-effector position to follow continuously (mouse drag)
+        Jog,        // a, b: end-effector displacement for this tick (arrow keys, joystick)
+        Linear,     // a, b: end point of a straight-line end-effector move in pixel coordinates
+        Joints      // a, b: joint angles for this tick (precomputed trajectories)
+    };
+
+    Type type = Type::Target;
+    float a = 0;
+    float b = 0;
+};
+
+#endif // COMMAND_HPP
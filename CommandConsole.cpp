@@ -0,0 +1,119 @@
+#include "CommandConsole.h"
+#include "Log.h"
+
+#include <cctype>
+#include <iostream>
+#include <sstream>
+#include <poll.h>
+#include <unistd.h>
+
+CommandConsole::CommandConsole() : queue(64), pending(static_cast<int>(ArmCommand::Type::TargetGrid)), running(false) {}
+
+CommandConsole::~CommandConsole() {
+    stop();
+}
+
+void CommandConsole::start() {
+    if (running.exchange(true)) return;
+    worker = std::thread(&CommandConsole::run, this);
+}
+
+void CommandConsole::stop() {
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+/**
+ * Function to prompt the operator for a command.
+ *
+ * Prints the prompt and remembers which command the next bare "x y" line is for.
+ * Returns immediately; the answer is parsed on the input thread.
+ *
+ * @param type The command the next line of input belongs to.
+ * @return none
+ */
+void CommandConsole::prompt(ArmCommand::Type type) {
+    pending = static_cast<int>(type);
+    switch (type) {
+        case ArmCommand::Type::TargetGrid:
+            std::cout << "Enter new target coordinates (tx ty): " << std::flush;
+            break;
+        case ArmCommand::Type::Lengths:
+            std::cout << "Enter new lengths for the upper and lower arm (L1 L2): " << std::flush;
+            break;
+        case ArmCommand::Type::Pivot:
+            std::cout << "Enter new zero point (X Y): " << std::flush;
+            break;
+        case ArmCommand::Type::Linear:
+            std::cout << "Enter the end point of the straight-line move (X Y): " << std::flush;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Input thread main loop.
+ *
+ * Polls stdin with a short timeout instead of blocking in std::getline, so the
+ * thread notices stop() and can be joined on shutdown.
+ *
+ * @return none
+ */
+void CommandConsole::run() {
+    std::string buffer;
+    char chunk[256];
+
+    while (running) {
+        pollfd pfd{STDIN_FILENO, POLLIN, 0};
+        if (::poll(&pfd, 1, 100) <= 0) continue;
+
+        ssize_t n = ::read(STDIN_FILENO, chunk, sizeof(chunk));
+        if (n <= 0) break; // EOF or error: no more console input
+
+        buffer.append(chunk, static_cast<size_t>(n));
+        size_t newline;
+        while ((newline = buffer.find('\n')) != std::string::npos) {
+            handleLine(buffer.substr(0, newline));
+            buffer.erase(0, newline + 1);
+        }
+    }
+}
+
+/**
+ * Function to parse one line of console input into a command.
+ *
+ * @param line The line without its trailing newline.
+ * @return none
+ */
+void CommandConsole::handleLine(const std::string& line) {
+    std::istringstream in(line);
+    auto type = static_cast<ArmCommand::Type>(pending.load());
+
+    char c = 0;
+    in >> std::ws;
+    if (std::isalpha(static_cast<unsigned char>(in.peek()))) {
+        in >> c;
+        switch (std::tolower(static_cast<unsigned char>(c))) {
+            case 'p': type = ArmCommand::Type::TargetGrid; break;
+            case 'm': type = ArmCommand::Type::Lengths; break;
+            case 'c': type = ArmCommand::Type::Pivot; break;
+            case 'i': type = ArmCommand::Type::Item; break;
+            case 'l': type = ArmCommand::Type::Linear; break;
+            default:
+                logWarning("Unknown command '", c, "'");
+                return;
+        }
+    }
+
+    ArmCommand command;
+    command.type = type;
+    if (!(in >> command.a >> command.b)) {
+        logWarning("Expected two numbers");
+        return;
+    }
+
+    if (!queue.push(command)) {
+        logWarning("Command queue full, input dropped");
+    }
+}
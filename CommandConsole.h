@@ -0,0 +1,43 @@
+#ifndef COMMANDCONSOLE_HPP
+#define COMMANDCONSOLE_HPP
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include "Command.h"
+#include "SpscQueue.h"
+
+/**
+ * Reads operator commands from stdin on a dedicated thread.
+ *
+ * Lines are parsed on the input thread and handed to the simulation through a
+ * lock-free SPSC queue, so typing never blocks rendering or the event loop.
+ * A line may either start with a command letter ("p 3 4", "m 120 80",
+ * "c 400 300", "i 250 250") or just contain the two numbers, in which case
+ * it is interpreted according to the last prompt() call (P, M or C key).
+ */
+class CommandConsole {
+public:
+    CommandConsole();
+    ~CommandConsole();
+
+    void start();
+    void stop();
+
+    // Print the prompt for a command and expect its arguments on the next line
+    void prompt(ArmCommand::Type type);
+
+    // Pop the next parsed command; called by the simulation at the tick boundary
+    bool poll(ArmCommand& command) { return queue.pop(command); }
+
+private:
+    void run();
+    void handleLine(const std::string& line);
+
+    SpscQueue<ArmCommand> queue;
+    std::atomic<int> pending;
+    std::atomic<bool> running;
+    std::thread worker;
+};
+
+#endif // COMMANDCONSOLE_HPP
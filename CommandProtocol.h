@@ -0,0 +1,38 @@
+#ifndef COMMANDPROTOCOL_HPP
+#define COMMANDPROTOCOL_HPP
+
+#include <cstdint>
+
+/*
+ * Binary protocol of the local command socket (see CommandServer).
+ *
+ * Each datagram is one CommandPacketHeader followed by `count` CommandRecords,
+ * all little-endian/native layout (the socket is local only). Record types use
+ * the numeric values of ArmCommand::Type. `sentNs` is CLOCK_MONOTONIC in
+ * nanoseconds at the sender and is used to report end-to-end latency; send 0
+ * if unknown.
+ */
+
+constexpr uint32_t kCommandMagic = 0x434D5241; // "ARMC"
+constexpr uint16_t kCommandProtocolVersion = 1;
+constexpr uint16_t kMaxCommandsPerPacket = 1024;
+
+struct CommandPacketHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+};
+
+struct CommandRecord {
+    uint8_t type;
+    uint8_t reserved[3];
+    float a;
+    float b;
+    uint32_t reserved2;
+    uint64_t sentNs;
+};
+
+static_assert(sizeof(CommandPacketHeader) == 8, "CommandPacketHeader layout");
+static_assert(sizeof(CommandRecord) == 24, "CommandRecord layout");
+
+#endif // COMMANDPROTOCOL_HPP
@@ -0,0 +1,192 @@
+#include "CommandServer.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+CommandServer::~CommandServer() {
+    close();
+}
+
+/**
+ * Function to open the command socket.
+ *
+ * Binds a non-blocking UNIX datagram socket at the given path, replacing a stale
+ * socket file left behind by a previous run.
+ *
+ * @param path The filesystem path of the socket.
+ * @return true if the socket is ready to receive commands.
+ */
+bool CommandServer::open(const std::string& path) {
+    close();
+
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        logError("Command socket path too long: ", path);
+        return false;
+    }
+
+    fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        logError("Failed to create command socket: ", std::strerror(errno));
+        return false;
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        logError("Failed to bind command socket ", path, ": ", std::strerror(errno));
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    // Let bursts queue up in the kernel between ticks
+    int bufferSize = 4 << 20;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    socketPath = path;
+    packet.resize(sizeof(CommandPacketHeader) + kMaxCommandsPerPacket * sizeof(CommandRecord));
+    lastReportNs = nowNs();
+    logInfo("Listening for commands on ", path);
+    return true;
+}
+
+void CommandServer::close() {
+    if (fd < 0) return;
+    ::close(fd);
+    ::unlink(socketPath.c_str());
+    fd = -1;
+}
+
+uint64_t CommandServer::nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * Function to drain the socket and coalesce commands for this tick.
+ *
+ * Reads every pending datagram without blocking. For each command type only the
+ * newest record is kept; the rest are counted as coalesced. The survivors are
+ * appended in the order geometry, pivot, target, item so a target is solved
+ * against the geometry sent with it.
+ *
+ * @param out The vector the coalesced commands are appended to.
+ * @return The number of commands appended.
+ */
+size_t CommandServer::poll(std::vector<ArmCommand>& out) {
+    if (fd < 0) return 0;
+
+    ArmCommand lengths, pivot, target, item;
+    bool hasLengths = false, hasPivot = false, hasTarget = false, hasItem = false;
+    uint64_t now = nowNs();
+
+    for (;;) {
+        ssize_t n = ::recv(fd, packet.data(), packet.size(), 0);
+        if (n < 0) break; // EAGAIN: drained
+
+        CommandPacketHeader header;
+        if (static_cast<size_t>(n) < sizeof(header)) { ++rejected; continue; }
+        std::memcpy(&header, packet.data(), sizeof(header));
+        if (header.magic != kCommandMagic || header.version != kCommandProtocolVersion
+            || static_cast<size_t>(n) != sizeof(header) + header.count * sizeof(CommandRecord)) {
+            ++rejected;
+            continue;
+        }
+
+        const char* cursor = packet.data() + sizeof(header);
+        for (uint16_t i = 0; i < header.count; ++i, cursor += sizeof(CommandRecord)) {
+            CommandRecord record;
+            std::memcpy(&record, cursor, sizeof(record));
+
+            ArmCommand command;
+            command.type = static_cast<ArmCommand::Type>(record.type);
+            command.a = record.a;
+            command.b = record.b;
+
+            bool* slotUsed;
+            ArmCommand* slot;
+            switch (command.type) {
+                case ArmCommand::Type::Target:
+                case ArmCommand::Type::TargetGrid:
+                case ArmCommand::Type::Linear:
+                case ArmCommand::Type::Joints: slot = &target; slotUsed = &hasTarget; break;
+                case ArmCommand::Type::Lengths: slot = &lengths; slotUsed = &hasLengths; break;
+                case ArmCommand::Type::Pivot: slot = &pivot; slotUsed = &hasPivot; break;
+                case ArmCommand::Type::Item: slot = &item; slotUsed = &hasItem; break;
+                default: ++rejected; continue;
+            }
+
+            ++received;
+            if (*slotUsed) ++coalesced;
+            *slot = command;
+            *slotUsed = true;
+            recordLatency(record.sentNs, now);
+        }
+    }
+
+    size_t before = out.size();
+    if (hasLengths) out.push_back(lengths);
+    if (hasPivot) out.push_back(pivot);
+    if (hasTarget) out.push_back(target);
+    if (hasItem) out.push_back(item);
+    return out.size() - before;
+}
+
+void CommandServer::recordLatency(uint64_t sentNs, uint64_t now) {
+    if (sentNs == 0 || sentNs > now) return;
+
+    uint64_t latency = now - sentNs;
+    uint64_t us = latency / 1000;
+    int bucket = 0;
+    while (us > 0 && bucket < 31) {
+        us >>= 1;
+        ++bucket;
+    }
+    ++latencyBuckets[bucket];
+    ++measured;
+    if (latency > maxLatencyNs) maxLatencyNs = latency;
+}
+
+/**
+ * Function to print command latency statistics.
+ *
+ * Latency is measured from the sender's timestamp to the tick that applies the
+ * command. Percentiles are upper bounds from a power-of-two histogram.
+ *
+ * @param intervalSeconds Minimum time between two reports.
+ * @return none
+ */
+void CommandServer::reportLatency(double intervalSeconds) {
+    uint64_t now = nowNs();
+    if (fd < 0 || static_cast<double>(now - lastReportNs) < intervalSeconds * 1e9) return;
+    lastReportNs = now;
+    if (received == 0 && rejected == 0) return;
+
+    auto percentile = [this](double p) -> uint64_t {
+        uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(measured));
+        uint64_t seen = 0;
+        for (int i = 0; i < 32; ++i) {
+            seen += latencyBuckets[i];
+            if (seen > rank) return i == 0 ? 1 : (1ull << i);
+        }
+        return 1ull << 31;
+    };
+
+    if (measured > 0) {
+        logInfo("IPC: ", received, " commands (", coalesced, " coalesced, ", rejected, " rejected), latency p50 <= ",
+                percentile(0.50), " us, p99 <= ", percentile(0.99), " us, max ", maxLatencyNs / 1000, " us");
+    } else {
+        logInfo("IPC: ", received, " commands (", coalesced, " coalesced, ", rejected, " rejected)");
+    }
+
+    received = coalesced = rejected = measured = maxLatencyNs = 0;
+    std::memset(latencyBuckets, 0, sizeof(latencyBuckets));
+}
@@ -0,0 +1,56 @@
+#ifndef COMMANDSERVER_HPP
+#define COMMANDSERVER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Command.h"
+#include "CommandProtocol.h"
+
+/**
+ * Local high-rate command endpoint on a UNIX datagram socket.
+ *
+ * External planners send batches of CommandRecords (CommandProtocol.h). The
+ * socket is drained without blocking once per tick and the batch is coalesced:
+ * only the newest target, geometry, pivot and item command survive, since
+ * anything older would be overwritten within the same tick anyway.
+ */
+class CommandServer {
+public:
+    CommandServer() = default;
+    ~CommandServer();
+
+    CommandServer(const CommandServer&) = delete;
+    CommandServer& operator=(const CommandServer&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    // Drain the socket and append the coalesced commands in apply order
+    // (geometry, pivot, target, item). Returns the number of commands appended.
+    size_t poll(std::vector<ArmCommand>& out);
+
+    // Print latency statistics if at least `intervalSeconds` have passed since the last report
+    void reportLatency(double intervalSeconds);
+
+    static uint64_t nowNs();
+
+private:
+    void recordLatency(uint64_t sentNs, uint64_t now);
+
+    int fd = -1;
+    std::string socketPath;
+    std::vector<char> packet;
+
+    // Latency statistics since the last report, in a log2 histogram of microseconds
+    uint64_t received = 0;
+    uint64_t coalesced = 0;
+    uint64_t rejected = 0;
+    uint64_t measured = 0;
+    uint64_t maxLatencyNs = 0;
+    uint64_t latencyBuckets[32] = {};
+    uint64_t lastReportNs = 0;
+};
+
+#endif // COMMANDSERVER_HPP
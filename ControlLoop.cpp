@@ -0,0 +1,252 @@
+#include "ControlLoop.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
+
+namespace {
+
+uint64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// Adds a duration to a log2 histogram of microseconds
+void recordDuration(uint64_t buckets[32], uint64_t& maxNs, uint64_t ns) {
+    uint64_t us = ns / 1000;
+    int bucket = 0;
+    while (us > 0 && bucket < 31) {
+        us >>= 1;
+        ++bucket;
+    }
+    ++buckets[bucket];
+    if (ns > maxNs) maxNs = ns;
+}
+
+// Upper bound (us) of the bucket holding the p-th percentile of `count` samples
+uint64_t percentile(const uint64_t buckets[32], uint64_t count, double p) {
+    uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count));
+    uint64_t seen = 0;
+    for (int i = 0; i < 32; ++i) {
+        seen += buckets[i];
+        if (seen > rank) return i == 0 ? 1 : (1ull << i);
+    }
+    return 1ull << 31;
+}
+
+} // namespace
+
+void ControlStats::add(const ControlStats& other) {
+    ticks += other.ticks;
+    overruns += other.overruns;
+    missed += other.missed;
+    maxJitterNs = std::max(maxJitterNs, other.maxJitterNs);
+    maxComputeNs = std::max(maxComputeNs, other.maxComputeNs);
+    for (int i = 0; i < 32; ++i) {
+        jitterBuckets[i] += other.jitterBuckets[i];
+        computeBuckets[i] += other.computeBuckets[i];
+    }
+}
+
+ControlLoop::ControlLoop() : commands(1024) {}
+
+ControlLoop::~ControlLoop() {
+    stop();
+}
+
+/**
+ * Function to start the control thread.
+ *
+ * The dynamics time step is set to the period, so simulated time keeps pace
+ * with the wall clock; the other per-tick rates (smoothing, track speed) stay
+ * per tick, as they are everywhere else.
+ *
+ * @param arms The initial arm state; copied.
+ * @param params The simulation parameters; dynamics are always on.
+ * @param rateHz The control rate (1 Hz to 100 kHz).
+ * @param rtPriority SCHED_FIFO priority of the thread, or 0 to keep the default policy.
+ * @param pool The task pool for the per-arm work, or nullptr. Only the control thread may use it meanwhile.
+ * @return True if the thread was started.
+ */
+bool ControlLoop::start(const std::vector<ArmState>& arms, const SimulationParams& params, double rateHz, int rtPriority,
+                        TaskPool* pool) {
+    stop();
+    if (arms.empty() || !(rateHz >= 1 && rateHz <= 100000)) {
+        logError("Control rate must be between 1 Hz and 100 kHz");
+        return false;
+    }
+
+    this->arms = arms;
+    this->params = params;
+    this->params.dynamics = true;
+    this->params.updateItems = false;
+    this->params.dynamicsParams.dt = static_cast<float>(1.0 / rateHz);
+    this->pool = pool;
+    periodNs = static_cast<uint64_t>(1e9 / rateHz);
+    published = arms;
+    stats = ControlStats();
+    pending = ControlStats();
+
+#ifdef __linux__
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (timerFd < 0) {
+        logError("Failed to create the control timer: ", std::strerror(errno));
+        return false;
+    }
+    itimerspec spec{};
+    spec.it_interval.tv_sec = static_cast<time_t>(periodNs / 1000000000ull);
+    spec.it_interval.tv_nsec = static_cast<long>(periodNs % 1000000000ull);
+    spec.it_value = spec.it_interval;
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+#endif
+    lastWakeNs = deadlineNs = monotonicNs();
+    lastReportNs = lastWakeNs;
+
+    running.store(true, std::memory_order_release);
+    worker = std::thread(&ControlLoop::run, this);
+
+    if (rtPriority > 0) {
+        sched_param schedule{};
+        schedule.sched_priority = rtPriority;
+        int error = pthread_setschedparam(worker.native_handle(), SCHED_FIFO, &schedule);
+        if (error != 0) {
+            logWarning("Could not set real-time priority ", rtPriority, " (", std::strerror(error),
+                       "); the control loop runs with the default policy");
+        }
+    }
+    logInfo("Control loop at ", rateHz, " Hz");
+    return true;
+}
+
+/**
+ * Function to stop the control thread.
+ *
+ * The published state stays readable through snapshot().
+ *
+ * @return none
+ */
+void ControlLoop::stop() {
+    if (!worker.joinable()) return;
+
+    running.store(false, std::memory_order_release);
+    worker.join(); // Within one period
+    if (timerFd >= 0) {
+        ::close(timerFd);
+        timerFd = -1;
+    }
+}
+
+/**
+ * Function to copy the arm state of the newest published tick.
+ *
+ * @param out The arms (output); storage is reused.
+ * @return none
+ */
+void ControlLoop::snapshot(std::vector<ArmState>& out) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    out = published;
+}
+
+/**
+ * Function to print the control loop timing.
+ *
+ * Jitter is how far each interval between two wake-ups strays from the
+ * period; compute is the time spent in the tick itself. Statistics are reset
+ * after printing.
+ *
+ * @param intervalSeconds Minimum time between two reports.
+ * @return none
+ */
+void ControlLoop::reportStats(double intervalSeconds) {
+    uint64_t now = monotonicNs();
+    std::lock_guard<std::mutex> lock(publishMutex);
+    if (static_cast<double>(now - lastReportNs) < intervalSeconds * 1e9) return;
+    lastReportNs = now;
+    if (stats.ticks == 0) return;
+
+    logInfo("Control: ", stats.ticks, " ticks, ", stats.overruns, " overruns, ", stats.missed,
+            " missed periods; jitter p50 <= ", percentile(stats.jitterBuckets, stats.ticks, 0.50), " us, p99 <= ",
+            percentile(stats.jitterBuckets, stats.ticks, 0.99), " us, max ", stats.maxJitterNs / 1000,
+            " us; compute p50 <= ", percentile(stats.computeBuckets, stats.ticks, 0.50), " us, p99 <= ",
+            percentile(stats.computeBuckets, stats.ticks, 0.99), " us, max ", stats.maxComputeNs / 1000, " us");
+    stats = ControlStats();
+}
+
+void ControlLoop::run() {
+    while (running.load(std::memory_order_acquire)) {
+        uint64_t expirations = waitForTick();
+        uint64_t wakeNs = monotonicNs();
+
+        tickCommands.clear();
+        ArmCommand command;
+        while (commands.pop(command)) tickCommands.push_back(command);
+        tickArms(arms, tickCommands, params, pool);
+
+        recordTick(expirations, wakeNs, monotonicNs());
+        if (publishMutex.try_lock()) {
+            published = arms;
+            stats.add(pending);
+            publishMutex.unlock();
+            pending = ControlStats();
+        }
+    }
+}
+
+// Blocks until the next period starts; returns the number of periods since the last wake-up
+uint64_t ControlLoop::waitForTick() {
+#ifdef __linux__
+    uint64_t expirations = 0;
+    while (read(timerFd, &expirations, sizeof(expirations)) != static_cast<ssize_t>(sizeof(expirations))) {
+        if (errno != EINTR) return 1;
+    }
+    return expirations;
+#else
+    deadlineNs += periodNs;
+    uint64_t now = monotonicNs();
+    uint64_t expirations = 1;
+    if (now >= deadlineNs + periodNs) {
+        // Overslept: skip the periods that already passed
+        uint64_t late = (now - deadlineNs) / periodNs;
+        deadlineNs += late * periodNs;
+        expirations += late;
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(deadlineNs > now ? deadlineNs - now : 0));
+    return expirations;
+#endif
+}
+
+void ControlLoop::recordTick(uint64_t expirations, uint64_t wakeNs, uint64_t doneNs) {
+    uint64_t interval = wakeNs - lastWakeNs;
+    uint64_t expected = expirations * periodNs;
+    lastWakeNs = wakeNs;
+
+    static Counter& ticks = metrics().counter("arm_control_ticks_total", "Ticks of the fixed-rate control thread.");
+    static Counter& missed = metrics().counter("arm_control_missed_periods_total", "Control periods that passed without a tick.");
+    static Counter& overruns = metrics().counter("arm_control_overruns_total", "Control ticks that took longer than one period.");
+
+    ++pending.ticks;
+    ticks.add();
+    if (expirations > 1) {
+        pending.missed += expirations - 1;
+        missed.add(expirations - 1);
+    }
+    recordDuration(pending.jitterBuckets, pending.maxJitterNs, interval > expected ? interval - expected : expected - interval);
+
+    uint64_t compute = doneNs - wakeNs;
+    recordDuration(pending.computeBuckets, pending.maxComputeNs, compute);
+    if (compute > periodNs) {
+        ++pending.overruns;
+        overruns.add();
+    }
+}
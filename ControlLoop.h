@@ -0,0 +1,90 @@
+#ifndef CONTROLLOOP_HPP
+#define CONTROLLOOP_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Command.h"
+#include "Simulation.h"
+#include "SpscQueue.h"
+
+class TaskPool;
+
+// Timing of the control thread, as log2 histograms of microseconds
+struct ControlStats {
+    uint64_t ticks = 0;
+    uint64_t overruns = 0; // Ticks that took longer than one period to compute
+    uint64_t missed = 0;   // Periods that passed without a tick
+    uint64_t maxJitterNs = 0, maxComputeNs = 0;
+    uint64_t jitterBuckets[32] = {};  // Deviation of each wake-up interval from the period
+    uint64_t computeBuckets[32] = {}; // Time spent in the tick
+
+    void add(const ControlStats& other);
+};
+
+/**
+ * Runs the arm dynamics and servo on a dedicated thread at a fixed rate.
+ *
+ * The thread wakes on a periodic timer (timerfd on Linux, sleep_until
+ * elsewhere), applies the queued commands and advances the arms one tick of
+ * 1 / rate seconds with params.dynamicsParams.law. A late tick is not caught
+ * up: the periods it slept through are counted as missed. After each tick the
+ * arm state is published for the render thread, which only ever reads it
+ * through snapshot(). Publishing uses try_lock, so a render thread holding the
+ * lock delays the next publish instead of the control loop.
+ *
+ * submit() belongs to one producer thread. The item list stays with that
+ * thread too: the control thread neither places nor carries items.
+ */
+class ControlLoop {
+public:
+    ControlLoop();
+    ~ControlLoop();
+
+    ControlLoop(const ControlLoop&) = delete;
+    ControlLoop& operator=(const ControlLoop&) = delete;
+
+    bool start(const std::vector<ArmState>& arms, const SimulationParams& params, double rateHz, int rtPriority,
+               TaskPool* pool);
+    void stop();
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+    // Queue a command for arms[0]; returns false if the queue is full
+    bool submit(const ArmCommand& command) { return commands.push(command); }
+
+    // Copy the arm state of the newest published tick
+    void snapshot(std::vector<ArmState>& out);
+
+    // Print timing statistics if at least `intervalSeconds` have passed since the last report
+    void reportStats(double intervalSeconds);
+
+private:
+    void run();
+    uint64_t waitForTick();
+    void recordTick(uint64_t expirations, uint64_t wakeNs, uint64_t doneNs);
+
+    SpscQueue<ArmCommand> commands;
+    std::atomic<bool> running{false};
+    std::thread worker;
+
+    // Owned by the control thread while it runs
+    std::vector<ArmState> arms;
+    std::vector<ArmCommand> tickCommands;
+    SimulationParams params;
+    TaskPool* pool = nullptr;
+    uint64_t periodNs = 0;
+    int timerFd = -1;
+    uint64_t deadlineNs = 0; // Next wake-up without a timerfd
+    uint64_t lastWakeNs = 0;
+    ControlStats pending;    // Statistics not yet published
+
+    // Published state, guarded by publishMutex
+    std::mutex publishMutex;
+    std::vector<ArmState> published;
+    ControlStats stats;
+    uint64_t lastReportNs = 0;
+};
+
+#endif // CONTROLLOOP_HPP
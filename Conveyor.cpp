@@ -0,0 +1,262 @@
+#include "Conveyor.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "Kinematics.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "Simulation.h"
+
+namespace {
+
+// Belt travel between two candidate intercepts when the direct solution is unusable (pixels)
+constexpr float kScanStep = 2.0f;
+
+bool reachable(const ArmState& arm, float x, float y) {
+    float angle1 = arm.currentAngle1, angle2 = arm.currentAngle2, moveTime;
+    bool elbowUp;
+    return selectArmConfiguration(arm.px, arm.py, x, y, arm.L1, arm.L2, jointLimits(arm), angle1, angle2, elbowUp, moveTime) == IkResult::Ok;
+}
+
+// Earliest t >= 0 with |d + v t| = s t, or -1 if the claw can never catch up
+float earliestMeeting(float dx, float dy, float vx, float s) {
+    float a = vx * vx - s * s;
+    float b = 2 * dx * vx;
+    float c = dx * dx + dy * dy;
+    if (std::fabs(a) < 1e-9f) return b < 0 ? -c / b : -1;
+
+    float disc = b * b - 4 * a * c;
+    if (disc < 0) return -1;
+    float root = std::sqrt(disc);
+    float t1 = (-b - root) / (2 * a), t2 = (-b + root) / (2 * a);
+    if (t1 > t2) std::swap(t1, t2);
+    if (t1 >= 0) return t1;
+    return t2 >= 0 ? t2 : -1;
+}
+
+} // namespace
+
+/**
+ * Function to compute where and when the claw can meet an item on the belt.
+ *
+ * The claw is assumed to move straight at trackSpeed pixels per tick, which is
+ * how tracking mode drives it. The closed-form meeting point is used when the
+ * arm can reach it; otherwise later points along the item's path are tried
+ * until one is both reachable and reachable in time, or the item leaves the belt.
+ *
+ * @param arm The arm (pivot, lengths and joint limits).
+ * @param clawX The current x-coordinate of the claw.
+ * @param clawY The current y-coordinate of the claw.
+ * @param itemX The current x-coordinate of the item.
+ * @param itemY The current y-coordinate of the item.
+ * @param conveyor The belt parameters.
+ * @param trackSpeed The claw speed (pixels per tick).
+ * @param x The x-coordinate of the intercept (output).
+ * @param y The y-coordinate of the intercept (output).
+ * @param ticks The ticks until the intercept (output).
+ * @return True if the item can be intercepted before it leaves the belt.
+ */
+bool computeIntercept(const ArmState& arm, float clawX, float clawY, float itemX, float itemY,
+                      const ConveyorParams& conveyor, float trackSpeed, float& x, float& y, float& ticks) {
+    float vx = conveyor.speed;
+    float dx = itemX - clawX, dy = itemY - clawY;
+
+    float t = earliestMeeting(dx, dy, vx, trackSpeed);
+    if (t >= 0) {
+        x = itemX + vx * t;
+        y = itemY;
+        ticks = t;
+        if (x <= conveyor.endX && reachable(arm, x, y)) return true;
+    }
+
+    // A stopped belt has no later points to try
+    if (vx <= 0) return false;
+
+    float step = kScanStep / vx;
+    for (t = t >= 0 ? t + step : 0; itemX + vx * t <= conveyor.endX; t += step) {
+        x = itemX + vx * t;
+        y = itemY;
+        float distance = std::sqrt((x - clawX) * (x - clawX) + dy * dy);
+        if (distance <= trackSpeed * t && reachable(arm, x, y)) {
+            ticks = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Function to advance the belt by one tick and emit the arm's tracking command.
+ *
+ * Spawns, moves and retires items, grabs the target when the claw is within the
+ * grab distance and delivers it at the drop point. The intercept is re-planned
+ * every tick from the claw's actual position, so the arm corrects for moving
+ * slower than planned near the edge of its reach. The plan is handed to the arm
+ * as a Track command, so it is recorded like any other input.
+ *
+ * @param conveyor The belt state.
+ * @param arm The arm picking from the belt.
+ * @param params The simulation parameters (track speed and grab distance).
+ * @param commands The tick's commands; the tracking command is appended (output).
+ * @return none
+ */
+void tickConveyor(ConveyorState& conveyor, const ArmState& arm, const SimulationParams& params,
+                  std::vector<ArmCommand>& commands) {
+    const ConveyorParams& belt = conveyor.params;
+    ++conveyor.stats.ticks;
+
+    // Spawn at the configured rate
+    if (belt.spawnRate > 0) {
+        double interval = belt.tickRate * 60.0 / belt.spawnRate;
+        conveyor.spawnClock += 1;
+        while (conveyor.spawnClock >= interval) {
+            conveyor.spawnClock -= interval;
+            conveyor.belt.push_back({belt.startX, belt.beltY});
+            ++conveyor.stats.spawned;
+        }
+    }
+
+    ArmPose pose = computePose(arm, params.fkTrig);
+
+    for (size_t i = 0; i < conveyor.belt.size();) {
+        ConveyorItem& item = conveyor.belt[i];
+        int index = static_cast<int>(i);
+
+        if (item.carried) {
+            // Carry the item at the claw tip, as updateGrab does
+            float clawAngle = arm.currentAngle1 + arm.currentAngle2;
+            item.x = pose.x3 + params.clawLength * std::cos(clawAngle);
+            item.y = pose.y3 + params.clawLength * std::sin(clawAngle);
+
+            float toDrop = std::sqrt((pose.x3 - belt.dropX) * (pose.x3 - belt.dropX) + (pose.y3 - belt.dropY) * (pose.y3 - belt.dropY));
+            if (toDrop < params.grabDistance) {
+                ++conveyor.stats.picked;
+                static Counter& picked = metrics().counter("arm_conveyor_items_total{outcome=\"picked\"}",
+                                                           "Conveyor items that left the belt, by outcome.");
+                picked.add();
+                conveyor.belt.erase(conveyor.belt.begin() + index);
+                if (conveyor.target == index) conveyor.target = -1;
+                else if (conveyor.target > index) --conveyor.target;
+                continue;
+            }
+        } else {
+            item.x += belt.speed;
+
+            if (item.x > belt.endX) {
+                ++conveyor.stats.missed;
+                static Counter& missed = metrics().counter("arm_conveyor_items_total{outcome=\"missed\"}",
+                                                           "Conveyor items that left the belt, by outcome.");
+                missed.add();
+                conveyor.belt.erase(conveyor.belt.begin() + index);
+                if (conveyor.target == index) conveyor.target = -1;
+                else if (conveyor.target > index) --conveyor.target;
+                continue;
+            }
+
+            float toClaw = std::sqrt((item.x - pose.x3) * (item.x - pose.x3) + (item.y - pose.y3) * (item.y - pose.y3));
+            if (conveyor.target == index && toClaw < params.grabDistance) {
+                item.carried = true;
+            }
+        }
+        ++i;
+    }
+
+    // Re-plan the current target, dropping it if it can no longer be caught
+    if (conveyor.target >= 0 && !conveyor.belt[conveyor.target].carried) {
+        const ConveyorItem& item = conveyor.belt[conveyor.target];
+        float x, y, ticks;
+        if (computeIntercept(arm, pose.x3, pose.y3, item.x, item.y, belt, params.trackSpeed, x, y, ticks)) {
+            if (std::fabs(x - conveyor.interceptX) > params.grabDistance || std::fabs(y - conveyor.interceptY) > params.grabDistance) {
+                ++conveyor.stats.replans;
+            }
+            conveyor.interceptX = x;
+            conveyor.interceptY = y;
+            conveyor.interceptTicks = ticks;
+        } else {
+            conveyor.target = -1;
+        }
+    }
+
+    // Otherwise pick the item closest to the end of the belt that can still be caught
+    if (conveyor.target < 0) {
+        float bestX = -std::numeric_limits<float>::infinity();
+        for (size_t i = 0; i < conveyor.belt.size(); ++i) {
+            const ConveyorItem& item = conveyor.belt[i];
+            float x, y, ticks;
+            if (item.x <= bestX) continue;
+            if (computeIntercept(arm, pose.x3, pose.y3, item.x, item.y, belt, params.trackSpeed, x, y, ticks)) {
+                bestX = item.x;
+                conveyor.target = static_cast<int>(i);
+                conveyor.interceptX = x;
+                conveyor.interceptY = y;
+                conveyor.interceptTicks = ticks;
+            }
+        }
+    }
+
+    if (conveyor.target < 0) return; // Nothing catchable; hold position
+
+    ArmCommand command;
+    command.type = ArmCommand::Type::Track;
+    if (conveyor.belt[conveyor.target].carried) {
+        command.a = belt.dropX;
+        command.b = belt.dropY;
+    } else {
+        command.a = conveyor.interceptX;
+        command.b = conveyor.interceptY;
+    }
+    commands.push_back(command);
+}
+
+/**
+ * Function to print conveyor throughput.
+ *
+ * Rates are per minute of simulated time (ticks / tickRate), so they do not
+ * depend on how fast the window happens to render.
+ *
+ * @param conveyor The belt state.
+ * @param interval Minimum simulated time between two reports (seconds).
+ * @return none
+ */
+void reportConveyor(ConveyorState& conveyor, double interval) {
+    const ConveyorStats& stats = conveyor.stats;
+    if (static_cast<double>(stats.ticks - conveyor.lastReportTick) < interval * conveyor.params.tickRate) return;
+    conveyor.lastReportTick = stats.ticks;
+
+    double minutes = static_cast<double>(stats.ticks) / conveyor.params.tickRate / 60.0;
+    logInfo("Conveyor: ", stats.picked, " picked (", stats.picked / minutes, "/min), ", stats.missed, " missed, ",
+            conveyor.belt.size(), " on belt, ", stats.replans, " replans");
+}
+
+/**
+ * Function to run the conveyor without a window.
+ *
+ * Used to size the belt speed and spawn rate for an arm: run the same scene at
+ * several speeds and keep the fastest one that does not miss items.
+ *
+ * The arms are advanced with tickArms, like the window loop does, so the
+ * dynamics mode applies here too.
+ *
+ * @param conveyor The belt state.
+ * @param arms The arms; arms[0] picks from the belt.
+ * @param params The simulation parameters.
+ * @param ticks The number of ticks to simulate.
+ * @return none
+ */
+void runHeadlessConveyor(ConveyorState& conveyor, std::vector<ArmState>& arms, const SimulationParams& params, uint64_t ticks) {
+    std::vector<ArmCommand> commands;
+    for (uint64_t tick = 0; tick < ticks; ++tick) {
+        commands.clear();
+        tickConveyor(conveyor, arms[0], params, commands);
+        tickArms(arms, commands, params);
+    }
+
+    const ConveyorStats& stats = conveyor.stats;
+    double minutes = static_cast<double>(stats.ticks) / conveyor.params.tickRate / 60.0;
+    double offered = static_cast<double>(stats.spawned) / minutes;
+    logInfo("Conveyor: belt ", conveyor.params.speed, " px/tick, ", conveyor.params.spawnRate, " items/min over ", minutes,
+            " min\n  spawned ", stats.spawned, " (", offered, "/min), picked ", stats.picked, " (",
+            stats.picked / minutes, "/min), missed ", stats.missed, ", on belt ", conveyor.belt.size(), ", replans ",
+            stats.replans);
+}
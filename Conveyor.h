@@ -0,0 +1,61 @@
+#ifndef CONVEYOR_HPP
+#define CONVEYOR_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Command.h"
+
+struct ArmState;
+struct SimulationParams;
+
+// A horizontal belt that carries items from startX to endX
+struct ConveyorParams {
+    float beltY = 420;          // Height of the belt line (pixels)
+    float startX = 0;           // Where items are spawned
+    float endX = 800;           // Items that pass this point unpicked are missed
+    float speed = 0.1f;         // Belt speed (pixels per tick, +x)
+    float spawnRate = 30;       // Items per minute
+    float dropX = 400, dropY = 180; // Where picked items are delivered
+    float tickRate = 1000;      // Simulation ticks per second, for the per-minute figures
+};
+
+struct ConveyorItem {
+    float x, y;
+    bool carried = false;
+};
+
+struct ConveyorStats {
+    uint64_t ticks = 0;
+    uint64_t spawned = 0;
+    uint64_t picked = 0;
+    uint64_t missed = 0;
+    uint64_t replans = 0; // Ticks on which the predicted intercept moved by more than the grab distance
+};
+
+// Belt contents, the arm's current pick plan and the running counters
+struct ConveyorState {
+    ConveyorParams params;
+    std::vector<ConveyorItem> belt;
+    double spawnClock = 0;  // Ticks accumulated towards the next spawn
+    int target = -1;        // Index into belt of the item being intercepted or carried
+    float interceptX = 0, interceptY = 0; // Predicted meeting point with the target
+    float interceptTicks = 0;             // Predicted ticks until the meeting
+    ConveyorStats stats;
+    uint64_t lastReportTick = 0;
+};
+
+// Function to compute where and when the claw can meet an item moving along the belt
+bool computeIntercept(const ArmState& arm, float clawX, float clawY, float itemX, float itemY,
+                      const ConveyorParams& conveyor, float trackSpeed, float& x, float& y, float& ticks);
+
+// Function to advance the belt by one tick and emit the arm's tracking command
+void tickConveyor(ConveyorState& conveyor, const ArmState& arm, const SimulationParams& params,
+                  std::vector<ArmCommand>& commands);
+
+// Function to print throughput and misses every interval seconds of simulated time
+void reportConveyor(ConveyorState& conveyor, double interval);
+
+// Function to run the conveyor without a window and print the achieved throughput; arms[0] picks
+void runHeadlessConveyor(ConveyorState& conveyor, std::vector<ArmState>& arms, const SimulationParams& params, uint64_t ticks);
+
+#endif // CONVEYOR_HPP
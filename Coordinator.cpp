@@ -0,0 +1,376 @@
+#include "Coordinator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include "FrameArena.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "Simulation.h"
+#include "TaskPool.h"
+
+namespace {
+
+constexpr uint64_t kCheckStep = 10;      // Ticks between two conflict checks along a move
+constexpr uint64_t kDelayStep = 50;      // Granularity of start delays (ticks)
+constexpr uint64_t kRetryInterval = 100; // Ticks before a blocked request is planned again
+
+struct Capsule {
+    float x1, y1, x2, y2;
+};
+
+// Both links of an arm at the given angles; the second one includes the claw
+void armCapsules(const ArmState& arm, const ArmSolution& angles, float clawLength, Capsule capsules[2]) {
+    float x2 = arm.px + arm.L1 * std::cos(angles.angle1);
+    float y2 = arm.py + arm.L1 * std::sin(angles.angle1);
+    float reach = arm.L2 + clawLength;
+    capsules[0] = {arm.px, arm.py, x2, y2};
+    capsules[1] = {x2, y2, x2 + reach * std::cos(angles.angle1 + angles.angle2), y2 + reach * std::sin(angles.angle1 + angles.angle2)};
+}
+
+float pointSegmentDistance2(float px, float py, const Capsule& s) {
+    float dx = s.x2 - s.x1, dy = s.y2 - s.y1;
+    float length2 = dx * dx + dy * dy;
+    float t = length2 > 0 ? std::clamp(((px - s.x1) * dx + (py - s.y1) * dy) / length2, 0.0f, 1.0f) : 0.0f;
+    float ex = s.x1 + t * dx - px, ey = s.y1 + t * dy - py;
+    return ex * ex + ey * ey;
+}
+
+// Squared distance between two segments: zero if they cross, otherwise attained at an end point
+float segmentDistance2(const Capsule& a, const Capsule& b) {
+    auto cross = [](float ax, float ay, float bx, float by, float cx, float cy) {
+        return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    };
+    float d1 = cross(a.x1, a.y1, a.x2, a.y2, b.x1, b.y1), d2 = cross(a.x1, a.y1, a.x2, a.y2, b.x2, b.y2);
+    float d3 = cross(b.x1, b.y1, b.x2, b.y2, a.x1, a.y1), d4 = cross(b.x1, b.y1, b.x2, b.y2, a.x2, a.y2);
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) return 0;
+
+    return std::min(std::min(pointSegmentDistance2(a.x1, a.y1, b), pointSegmentDistance2(a.x2, a.y2, b)),
+                    std::min(pointSegmentDistance2(b.x1, b.y1, a), pointSegmentDistance2(b.x2, b.y2, a)));
+}
+
+// Joint angles of a reserved move at tick t: the closed form of the lerp in stepArm
+ArmSolution anglesAt(const Reservation& reservation, uint64_t t, float smoothFactor) {
+    if (t <= reservation.start) return reservation.from;
+    if (t >= reservation.end) return reservation.to;
+    float remaining = std::pow(1 - smoothFactor, static_cast<float>(t - reservation.start));
+    return {reservation.to.angle1 + (reservation.from.angle1 - reservation.to.angle1) * remaining,
+            reservation.to.angle2 + (reservation.from.angle2 - reservation.to.angle2) * remaining};
+}
+
+// Fastest claw speed of a reserved move (at its start), to cover the motion between two checks
+float peakSpeed(const ArmState& arm, const Reservation& reservation, float clawLength, float smoothFactor) {
+    if (reservation.end <= reservation.start) return 0;
+    float d1 = std::abs(reservation.to.angle1 - reservation.from.angle1);
+    float d2 = std::abs(reservation.to.angle2 - reservation.from.angle2);
+    return smoothFactor * (d1 * (arm.L1 + arm.L2 + clawLength) + d2 * (arm.L2 + clawLength));
+}
+
+// Checks two reservations from `now` until both arms rest; an arm whose move starts later rests at `from` until then
+bool pairConflicts(const std::vector<ArmState>& arms, size_t i, const Reservation& a, size_t j, const Reservation& b,
+                   const SimulationParams& params, float clearance, uint64_t now) {
+    uint64_t begin = std::max(now, std::min(a.start, b.start)); // Ticks before now are past
+    uint64_t end = std::max(a.end, b.end);
+
+    float margin = 0.5f * kCheckStep * (peakSpeed(arms[i], a, params.clawLength, params.smoothFactor)
+                                        + peakSpeed(arms[j], b, params.clawLength, params.smoothFactor));
+    float limit = params.thickness + clearance + margin;
+    float limit2 = limit * limit;
+
+    for (uint64_t t = begin;; t = std::min(end, t + kCheckStep)) {
+        Capsule ca[2], cb[2];
+        armCapsules(arms[i], anglesAt(a, t, params.smoothFactor), params.clawLength, ca);
+        armCapsules(arms[j], anglesAt(b, t, params.smoothFactor), params.clawLength, cb);
+        for (const Capsule& x : ca) {
+            for (const Capsule& y : cb) {
+                if (segmentDistance2(x, y) < limit2) return true;
+            }
+        }
+        if (t >= end) return false;
+    }
+}
+
+// Reachable configurations for a request, the preferred (shortest move) one first
+int candidateConfigurations(const ArmState& arm, float x, float y, ArmSolution configurations[2]) {
+    JointLimits limits = jointLimits(arm);
+    ArmSolution preferred{arm.currentAngle1, arm.currentAngle2};
+    bool elbowUp;
+    float moveTime;
+    if (selectArmConfiguration(arm.px, arm.py, x, y, arm.L1, arm.L2, limits, preferred.angle1, preferred.angle2, elbowUp, moveTime) != IkResult::Ok) {
+        return 0;
+    }
+    configurations[0] = preferred;
+
+    ArmSolution up, down;
+    solveArmConfigurations(arm.px, arm.py, x, y, arm.L1, arm.L2, up, down);
+    const ArmSolution& other = elbowUp ? down : up;
+    ArmSolution alternative;
+    if (std::abs(other.angle2 - (elbowUp ? up : down).angle2) < 1e-4f) return 1; // Stretched: both branches coincide
+    if (!unwrapAngle(other.angle1, arm.currentAngle1, limits.min1, limits.max1, alternative.angle1)
+        || !unwrapAngle(other.angle2, arm.currentAngle2, limits.min2, limits.max2, alternative.angle2)) {
+        return 1;
+    }
+    configurations[1] = alternative;
+    return 2;
+}
+
+struct Plan {
+    bool found = false;
+    bool replanned = false;
+    Reservation reservation;
+};
+
+/**
+ * Finds the earliest conflict-free start for an arm's next request against the
+ * other arms' reservations: first with the preferred configuration, delaying
+ * in kDelayStep steps until every other arm has finished its move, then with
+ * the other elbow configuration.
+ */
+Plan planRequest(const CoordinatorState& coordinator, const std::vector<ArmState>& arms, size_t i,
+                 const SimulationParams& params) {
+    Plan plan;
+    const ArmState& arm = arms[i];
+    const MoveRequest& request = coordinator.arms[i].queue.front();
+
+    ArmSolution configurations[2];
+    int count = candidateConfigurations(arm, request.x, request.y, configurations);
+
+    uint64_t settled = coordinator.tick;
+    for (size_t j = 0; j < arms.size(); ++j) {
+        if (j != i) settled = std::max(settled, coordinator.arms[j].reservation.end);
+    }
+
+    for (int c = 0; c < count; ++c) {
+        Reservation candidate;
+        candidate.from = {arm.currentAngle1, arm.currentAngle2};
+        candidate.to = configurations[c];
+        float delta = std::max(std::abs(candidate.to.angle1 - candidate.from.angle1), std::abs(candidate.to.angle2 - candidate.from.angle2));
+        uint64_t duration = static_cast<uint64_t>(settleTicks(delta, params.smoothFactor));
+
+        for (uint64_t start = coordinator.tick;; start += kDelayStep) {
+            candidate.start = start;
+            candidate.end = start + duration;
+
+            bool conflict = false;
+            for (size_t j = 0; j < arms.size() && !conflict; ++j) {
+                if (j == i) continue;
+                conflict = pairConflicts(arms, i, candidate, j, coordinator.arms[j].reservation, params, coordinator.clearance,
+                                         coordinator.tick);
+            }
+            if (!conflict) {
+                plan.found = true;
+                plan.replanned = c > 0;
+                plan.reservation = candidate;
+                return plan;
+            }
+            if (start >= settled) break; // Everyone else is at rest; waiting longer cannot help
+        }
+    }
+    return plan;
+}
+
+// Hands a reserved move to the arm's regular lerp motion
+void startMove(CoordinatedArm& slot, ArmState& arm) {
+    arm.tracking = false;
+    arm.linear = false;
+    arm.tx = slot.tx;
+    arm.ty = slot.ty;
+    arm.targetAngle1 = slot.reservation.to.angle1;
+    arm.targetAngle2 = slot.reservation.to.angle2;
+    arm.elbowUp = std::sin(arm.targetAngle2) >= 0;
+    arm.moveTicks = static_cast<float>(slot.reservation.end - slot.reservation.start);
+    slot.scheduled = false;
+    slot.moving = true;
+}
+
+} // namespace
+
+void submitMove(CoordinatorState& coordinator, size_t arm, float x, float y) {
+    if (arm < coordinator.arms.size()) coordinator.arms[arm].queue.push_back({x, y});
+}
+
+/**
+ * Function to plan queued moves and start those that cannot collide.
+ *
+ * Each arm's reservation describes its current move, or the pose it rests in.
+ * Arms with a queued request plan in parallel (one pool task per arm) against
+ * a snapshot of those reservations: the earliest start (possibly delayed) and
+ * configuration whose capsules stay clear of every other arm over the whole
+ * move. Plans are then committed in arm order, re-checked against plans
+ * committed in the same round; a plan that lost that race is retried on the
+ * next tick.
+ *
+ * @param coordinator The coordinator state.
+ * @param arms The arms, in the same order as coordinator.arms.
+ * @param params The simulation parameters (smoothing, link thickness, claw length).
+ * @return none
+ */
+void tickCoordinator(CoordinatorState& coordinator, std::vector<ArmState>& arms, const SimulationParams& params) {
+    if (coordinator.arms.size() != arms.size()) {
+        coordinator.arms.assign(arms.size(), CoordinatedArm());
+        for (size_t i = 0; i < arms.size(); ++i) {
+            Reservation& rest = coordinator.arms[i].reservation;
+            rest.from = rest.to = {arms[i].currentAngle1, arms[i].currentAngle2};
+            rest.start = rest.end = coordinator.tick;
+        }
+    }
+    uint64_t tick = coordinator.tick;
+    FrameArena::Scope scratch(frameArena());
+
+    // Start scheduled moves and retire finished ones
+    for (size_t i = 0; i < arms.size(); ++i) {
+        CoordinatedArm& slot = coordinator.arms[i];
+        if (slot.scheduled && tick >= slot.reservation.start) startMove(slot, arms[i]);
+        if (slot.moving && tick >= slot.reservation.end) {
+            slot.moving = false;
+            ++slot.stats.moves;
+            static Counter& completed = metrics().counter("arm_trajectories_completed_total{kind=\"coordinated\"}",
+                                                          "Trajectories that ran to their end, by kind.");
+            completed.add();
+        }
+
+        if (coordinator.randomWork && slot.queue.empty() && !slot.scheduled && !slot.moving) {
+            const ArmState& arm = arms[i];
+            std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+            std::uniform_real_distribution<float> distance(std::abs(arm.L1 - arm.L2) * 1.1f + 5, (arm.L1 + arm.L2) * 0.9f);
+            for (int attempt = 0; attempt < 16; ++attempt) {
+                float a = angle(coordinator.rng), d = distance(coordinator.rng);
+                MoveRequest request{arm.px + d * std::cos(a), arm.py + d * std::sin(a)};
+                ArmSolution configurations[2];
+                if (candidateConfigurations(arm, request.x, request.y, configurations) > 0) {
+                    slot.queue.push_back(request);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Plan every idle arm with work, in parallel against the current reservations
+    ArenaVector<size_t> planners;
+    planners.reserve(arms.size());
+    for (size_t i = 0; i < arms.size(); ++i) {
+        const CoordinatedArm& slot = coordinator.arms[i];
+        if (!slot.queue.empty() && !slot.scheduled && !slot.moving && tick >= slot.retryTick) planners.push_back(i);
+    }
+
+    // One task per planning arm; arm i prefers worker i, so its planning state stays on one core
+    ArenaVector<Plan> plans(planners.size());
+    auto plan = [&](size_t k) { plans[k] = planRequest(coordinator, arms, planners[k], params); };
+    if (coordinator.pool && planners.size() > 1) {
+        for (size_t k = 0; k < planners.size(); ++k) {
+            coordinator.pool->submit(planners[k], [&plan, k] { plan(k); }); // Small enough for std::function to store inline
+        }
+        coordinator.pool->wait();
+    } else {
+        for (size_t k = 0; k < planners.size(); ++k) plan(k);
+    }
+
+    ArenaVector<size_t> committed;
+    committed.reserve(planners.size());
+    for (size_t k = 0; k < planners.size(); ++k) {
+        size_t i = planners[k];
+        CoordinatedArm& slot = coordinator.arms[i];
+        const ArmState& arm = arms[i];
+        if (!plans[k].found) {
+            // Unreachable requests are dropped; blocked ones wait for the others to move, except
+            // random work, where two arms resting on each other's targets would wait forever
+            ArmSolution configurations[2];
+            if (coordinator.randomWork || candidateConfigurations(arm, slot.queue.front().x, slot.queue.front().y, configurations) == 0) {
+                slot.queue.pop_front();
+            } else {
+                slot.retryTick = tick + kRetryInterval;
+            }
+            continue;
+        }
+
+        bool conflict = false;
+        for (size_t j : committed) {
+            if (pairConflicts(arms, i, plans[k].reservation, j, coordinator.arms[j].reservation, params, coordinator.clearance, tick)) {
+                conflict = true;
+                break;
+            }
+        }
+        if (conflict) {
+            slot.retryTick = tick + 1;
+            continue;
+        }
+
+        slot.reservation = plans[k].reservation;
+        slot.tx = slot.queue.front().x;
+        slot.ty = slot.queue.front().y;
+        slot.queue.pop_front();
+        slot.scheduled = true;
+        if (plans[k].reservation.start > tick) ++slot.stats.delayed;
+        if (plans[k].replanned) ++slot.stats.replanned;
+        committed.push_back(i);
+    }
+
+    // Moves due now start this tick, so their arms do not count as waiting
+    for (size_t i : committed) {
+        if (coordinator.arms[i].reservation.start <= tick) startMove(coordinator.arms[i], arms[i]);
+    }
+
+    for (CoordinatedArm& slot : coordinator.arms) {
+        if (slot.moving) ++slot.stats.movingTicks;
+        else if (slot.scheduled || !slot.queue.empty()) ++slot.stats.waitingTicks;
+    }
+    ++coordinator.tick;
+}
+
+/**
+ * Function to print per-arm throughput and the time lost to waiting.
+ *
+ * "Lost" is the share of an arm's time spent with a move queued but held back
+ * for another arm; the throughput without waiting extrapolates the achieved
+ * moves to the ticks the arm was not held back. Rates are per minute of
+ * simulated time (ticks / coordinator.tickRate).
+ *
+ * @param coordinator The coordinator state.
+ * @param interval Minimum simulated time between two reports (seconds).
+ * @return none
+ */
+void reportCoordinator(CoordinatorState& coordinator, double interval) {
+    if (static_cast<double>(coordinator.tick - coordinator.lastReportTick) < interval * coordinator.tickRate) return;
+    coordinator.lastReportTick = coordinator.tick;
+
+    double minutes = static_cast<double>(coordinator.tick) / coordinator.tickRate / 60.0;
+    uint64_t moves = 0, waiting = 0;
+    double unblocked = 0;
+    std::ostringstream report; // One message, so the per-message rate limit never cuts the arm lines
+    for (size_t i = 0; i < coordinator.arms.size(); ++i) {
+        const CoordinatedArmStats& stats = coordinator.arms[i].stats;
+        double waitShare = coordinator.tick > 0 ? 100.0 * static_cast<double>(stats.waitingTicks) / static_cast<double>(coordinator.tick) : 0;
+        report << "Arm " << i << ": " << stats.moves << " moves (" << stats.moves / minutes << "/min), waiting "
+               << waitShare << "%, " << stats.delayed << " delayed, " << stats.replanned << " replanned\n";
+        moves += stats.moves;
+        waiting += stats.waitingTicks;
+        if (coordinator.tick > stats.waitingTicks) {
+            unblocked += static_cast<double>(stats.moves) * static_cast<double>(coordinator.tick) / static_cast<double>(coordinator.tick - stats.waitingTicks);
+        }
+    }
+    double armTicks = static_cast<double>(coordinator.tick) * static_cast<double>(coordinator.arms.size());
+    report << "Coordinator: " << moves / minutes << " moves/min, " << unblocked / minutes << " without waiting, "
+           << (armTicks > 0 ? 100.0 * static_cast<double>(waiting) / armTicks : 0) << "% of arm time lost to waiting\n";
+    logInfo(report.str());
+}
+
+/**
+ * Function to run a random workload on all arms without a window.
+ *
+ * @param coordinator The coordinator state (randomWork is switched on).
+ * @param arms The arms.
+ * @param params The simulation parameters.
+ * @param ticks The number of ticks to simulate.
+ * @return none
+ */
+void runHeadlessCoordinator(CoordinatorState& coordinator, std::vector<ArmState>& arms, const SimulationParams& params, uint64_t ticks) {
+    coordinator.randomWork = true;
+    std::vector<ArmCommand> commands;
+    for (uint64_t tick = 0; tick < ticks; ++tick) {
+        tickCoordinator(coordinator, arms, params);
+        tickArms(arms, commands, params, coordinator.pool);
+    }
+    coordinator.lastReportTick = 0;
+    reportCoordinator(coordinator, 0);
+    if (coordinator.pool) coordinator.pool->reportStats(0);
+}
@@ -0,0 +1,70 @@
+#ifndef COORDINATOR_HPP
+#define COORDINATOR_HPP
+
+#include <cstdint>
+#include <list>
+#include <random>
+#include <vector>
+#include "Kinematics.h"
+#include "PoolAllocator.h"
+
+struct ArmState;
+struct SimulationParams;
+class TaskPool;
+
+// A point-to-point move the coordinator has committed to, with the interval it occupies
+struct Reservation {
+    uint64_t start = 0, end = 0; // Ticks; the arm rests at `to` from `end` on
+    ArmSolution from{}, to{};    // Joint angles at start and after the move
+};
+
+struct CoordinatedArmStats {
+    uint64_t moves = 0;       // Moves completed
+    uint64_t movingTicks = 0;
+    uint64_t waitingTicks = 0; // Ticks with a request queued that could not start yet
+    uint64_t delayed = 0;      // Moves started later than requested to let another arm pass
+    uint64_t replanned = 0;    // Moves that switched elbow configuration to avoid a conflict
+};
+
+struct MoveRequest {
+    float x, y;
+};
+
+// Requests come and go every move; pooled nodes keep that off the heap
+using MoveQueue = std::list<MoveRequest, PoolAllocator<MoveRequest>>;
+
+struct CoordinatedArm {
+    MoveQueue queue;
+    Reservation reservation;
+    float tx = 0, ty = 0;  // Target of the reserved move
+    bool scheduled = false; // Reserved, waiting for its start tick
+    bool moving = false;
+    uint64_t retryTick = 0; // Next tick at which a blocked request is planned again
+    CoordinatedArmStats stats;
+};
+
+// Coordinator for arms whose reach circles overlap
+struct CoordinatorState {
+    std::vector<CoordinatedArm> arms;
+    uint64_t tick = 0;
+    float clearance = 6;      // Minimum distance between the link capsules of two arms (pixels)
+    float tickRate = 1000;    // Simulation ticks per second, for the per-minute figures (simulated, not wall-clock, time)
+    bool randomWork = false;  // Queue a random reachable target whenever an arm runs out of work
+    std::mt19937 rng{1234};
+    TaskPool* pool = nullptr; // Plans the arms in parallel when set
+    uint64_t lastReportTick = 0;
+};
+
+// Function to queue a move of one arm to a point
+void submitMove(CoordinatorState& coordinator, size_t arm, float x, float y);
+
+// Function to plan queued moves and start those that cannot collide with the other arms
+void tickCoordinator(CoordinatorState& coordinator, std::vector<ArmState>& arms, const SimulationParams& params);
+
+// Function to print per-arm throughput and the time lost to waiting
+void reportCoordinator(CoordinatorState& coordinator, double interval);
+
+// Function to run a random workload on all arms without a window and print the report
+void runHeadlessCoordinator(CoordinatorState& coordinator, std::vector<ArmState>& arms, const SimulationParams& params, uint64_t ticks);
+
+#endif // COORDINATOR_HPP
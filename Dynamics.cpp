@@ -0,0 +1,223 @@
+#include "Dynamics.h"
+
+#include <algorithm>
+#include <cmath>
+#include "FastMath.h"
+
+namespace {
+
+// The arrays of a batch never overlap. Telling the compiler so spares it the
+// dozens of runtime overlap checks it would otherwise give up on, and the
+// per-arm loops vectorize (at -O3, e.g. Release builds).
+#if defined(__clang__)
+#define DYNAMICS_NO_ALIAS _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define DYNAMICS_NO_ALIAS _Pragma("GCC ivdep")
+#else
+#define DYNAMICS_NO_ALIAS
+#endif
+
+constexpr float kFrictionSmoothing = 1e-3f; // Velocity (rad/s) over which Coulomb friction ramps up
+
+// Mass properties of one arm; the payload is folded into the second link
+struct MassProperties {
+    float m2;        // Second link plus payload
+    float lc1, lc2;  // Joint-to-centre-of-mass distances
+    float I1, I2;    // Inertias about the centres of mass
+};
+
+// Kept inline and branch-free so the loops below vectorize across arms
+inline MassProperties massProperties(const DynamicsParams& params, float L1, float L2) {
+    MassProperties mass;
+    mass.m2 = params.m2 + params.payload;
+    mass.lc1 = params.com1 * L1;
+    float link2 = params.com2 * L2;
+    mass.lc2 = (params.m2 * link2 + params.payload * L2) / mass.m2;
+
+    // Uniform rods, shifted to the combined centre of mass (parallel axis theorem)
+    mass.I1 = params.m1 * L1 * L1 * (1.0f / 12.0f);
+    mass.I2 = params.m2 * L2 * L2 * (1.0f / 12.0f) + params.m2 * (link2 - mass.lc2) * (link2 - mass.lc2)
+              + params.payload * (L2 - mass.lc2) * (L2 - mass.lc2);
+    return mass;
+}
+
+inline void gravityTerms(const DynamicsParams& params, const MassProperties& mass, float L1, float cos1, float cos12,
+                         float& gravity1, float& gravity2) {
+    // Potential energy -g * sum(m y): with y pointing down, gravity pulls the angles towards +pi/2
+    gravity2 = -params.gravity * mass.m2 * mass.lc2 * cos12;
+    gravity1 = -params.gravity * (params.m1 * mass.lc1 + mass.m2 * L1) * cos1 + gravity2;
+}
+
+// Mass matrix and the velocity and gravity terms of M(q) q'' + bias(q, q') = tau
+struct ArmTerms {
+    float m11, m12, m22;
+    float bias1, bias2; // Coriolis, centrifugal, gravity and friction torques
+};
+
+inline ArmTerms armTerms(const DynamicsParams& params, float L1, float L2, float q1, float q2, float dq1, float dq2) {
+    MassProperties mass = massProperties(params, L1, L2);
+    float sin1, cos1, sin2, cos2, sin12, cos12;
+    fastSinCos(q1, sin1, cos1);
+    fastSinCos(q2, sin2, cos2);
+    fastSinCos(q1 + q2, sin12, cos12);
+
+    ArmTerms terms;
+    float coupling = mass.m2 * L1 * mass.lc2;
+    terms.m22 = mass.I2 + mass.m2 * mass.lc2 * mass.lc2;
+    terms.m12 = terms.m22 + coupling * cos2;
+    terms.m11 = mass.I1 + params.m1 * mass.lc1 * mass.lc1 + terms.m22 + mass.m2 * L1 * L1 + 2 * coupling * cos2;
+
+    float h = coupling * sin2;
+    float gravity1, gravity2;
+    gravityTerms(params, mass, L1, cos1, cos12, gravity1, gravity2);
+    float friction1 = params.viscous1 * dq1 + params.coulomb1 * dq1 / (std::abs(dq1) + kFrictionSmoothing);
+    float friction2 = params.viscous2 * dq2 + params.coulomb2 * dq2 / (std::abs(dq2) + kFrictionSmoothing);
+    terms.bias1 = -h * (2 * dq1 * dq2 + dq2 * dq2) + gravity1 + friction1;
+    terms.bias2 = h * dq1 * dq1 + gravity2 + friction2;
+    return terms;
+}
+
+// One control law over a range; a template so each law gets its own branch-free loop
+template <ControlLaw law>
+void servoRange(DynamicsBatch& batch, const DynamicsParams& params, size_t begin, size_t end) {
+    DYNAMICS_NO_ALIAS
+    for (size_t i = begin; i < end; ++i) {
+        float error1 = batch.setpoint1[i] - batch.angle1[i];
+        float error2 = batch.setpoint2[i] - batch.angle2[i];
+        float rateError1 = batch.setpointVelocity1[i] - batch.velocity1[i];
+        float rateError2 = batch.setpointVelocity2[i] - batch.velocity2[i];
+        float torque1, torque2;
+
+        if constexpr (law == ControlLaw::ComputedTorque) {
+            // Feedback linearization: the joints see a critically damped second-order error response
+            ArmTerms terms = armTerms(params, batch.L1[i], batch.L2[i], batch.angle1[i], batch.angle2[i],
+                                      batch.velocity1[i], batch.velocity2[i]);
+            float kp = params.bandwidth * params.bandwidth, kd = 2 * params.bandwidth;
+            float acceleration1 = batch.setpointAcceleration1[i] + kp * error1 + kd * rateError1;
+            float acceleration2 = batch.setpointAcceleration2[i] + kp * error2 + kd * rateError2;
+            torque1 = terms.m11 * acceleration1 + terms.m12 * acceleration2 + terms.bias1;
+            torque2 = terms.m12 * acceleration1 + terms.m22 * acceleration2 + terms.bias2;
+        } else {
+            float sin1, cos1, sin12, cos12;
+            fastSinCos(batch.angle1[i], sin1, cos1);
+            fastSinCos(batch.angle1[i] + batch.angle2[i], sin12, cos12);
+            float gravity1, gravity2;
+            gravityTerms(params, massProperties(params, batch.L1[i], batch.L2[i]), batch.L1[i], cos1, cos12, gravity1, gravity2);
+            torque1 = gravity1 + params.kp1 * error1 + params.kd1 * rateError1;
+            torque2 = gravity2 + params.kp2 * error2 + params.kd2 * rateError2;
+
+            if constexpr (law == ControlLaw::Pid) {
+                float integral1 = std::clamp(batch.integral1[i] + error1 * params.dt, -params.integralLimit, params.integralLimit);
+                float integral2 = std::clamp(batch.integral2[i] + error2 * params.dt, -params.integralLimit, params.integralLimit);
+                batch.integral1[i] = integral1;
+                batch.integral2[i] = integral2;
+                torque1 += params.ki1 * integral1;
+                torque2 += params.ki2 * integral2;
+            }
+        }
+
+        batch.torque1[i] = std::clamp(torque1, -batch.maxTorque1[i], batch.maxTorque1[i]);
+        batch.torque2[i] = std::clamp(torque2, -batch.maxTorque2[i], batch.maxTorque2[i]);
+    }
+}
+
+} // namespace
+
+void DynamicsBatch::resize(size_t count) {
+    for (std::vector<float>* array : {&L1, &L2, &maxTorque1, &maxTorque2, &angle1, &angle2, &velocity1, &velocity2,
+                                      &setpoint1, &setpoint2, &setpointVelocity1, &setpointVelocity2, &setpointAcceleration1,
+                                      &setpointAcceleration2, &integral1, &integral2, &torque1, &torque2}) {
+        array->resize(count, 0.0f);
+    }
+}
+
+/**
+ * Function to compute the joint torques that hold an arm still against gravity.
+ *
+ * @param params The mass properties.
+ * @param L1 The length of the first link (m).
+ * @param L2 The length of the second link (m).
+ * @param angle1 The angle of the first joint.
+ * @param angle2 The angle of the second joint.
+ * @param torque1 The holding torque of the first joint (output, N m).
+ * @param torque2 The holding torque of the second joint (output, N m).
+ * @return none
+ */
+void gravityTorques(const DynamicsParams& params, float L1, float L2, float angle1, float angle2, float& torque1, float& torque2) {
+    float sin1, cos1, sin12, cos12;
+    fastSinCos(angle1, sin1, cos1);
+    fastSinCos(angle1 + angle2, sin12, cos12);
+    gravityTerms(params, massProperties(params, L1, L2), L1, cos1, cos12, torque1, torque2);
+}
+
+/**
+ * Function to set the motor torques from the servo setpoints.
+ *
+ * Pd and Pid act on the position and velocity error to the moving setpoint,
+ * with gravity compensation; Pid integrates the position error with a bounded
+ * integral. ComputedTorque cancels the modelled dynamics and adds the
+ * setpoint acceleration, so the tracking error decays at params.bandwidth
+ * whatever the pose, as long as the motors keep up. Every law saturates at
+ * the motor torque limits. Saturation is what tells whether a motor is big
+ * enough for a move: the arm lags the setpoint instead of following it.
+ *
+ * @param batch The arms.
+ * @param params The mass properties, control law and gains.
+ * @param begin The first arm.
+ * @param end One past the last arm.
+ * @return none
+ */
+void servoTorques(DynamicsBatch& batch, const DynamicsParams& params, size_t begin, size_t end) {
+    switch (params.law) {
+        case ControlLaw::Pd:
+            servoRange<ControlLaw::Pd>(batch, params, begin, end);
+            break;
+        case ControlLaw::Pid:
+            servoRange<ControlLaw::Pid>(batch, params, begin, end);
+            break;
+        case ControlLaw::ComputedTorque:
+            servoRange<ControlLaw::ComputedTorque>(batch, params, begin, end);
+            break;
+    }
+}
+
+/**
+ * Function to advance a range of arms by one time step.
+ *
+ * Closed-form two-link equations of motion, M(q) q'' + C(q, q') + G(q) + F(q')
+ * = tau, with the 2x2 mass matrix inverted directly. Friction is viscous plus
+ * Coulomb, smoothed near zero velocity so a resting joint does not chatter.
+ * Semi-implicit (symplectic) Euler: velocities are updated first and the new
+ * velocities move the angles, which keeps the undamped arm's energy bounded.
+ *
+ * The loop is branch-free over structure-of-arrays data and uses fastSinCos,
+ * so the compiler vectorizes it across arms.
+ *
+ * @param batch The arms; angles and velocities are updated in place.
+ * @param params The mass properties, friction and time step.
+ * @param begin The first arm.
+ * @param end One past the last arm.
+ * @return none
+ */
+void stepDynamics(DynamicsBatch& batch, const DynamicsParams& params, size_t begin, size_t end) {
+    float dt = params.dt;
+    DYNAMICS_NO_ALIAS
+    for (size_t i = begin; i < end; ++i) {
+        float q1 = batch.angle1[i], q2 = batch.angle2[i];
+        float dq1 = batch.velocity1[i], dq2 = batch.velocity2[i];
+        ArmTerms terms = armTerms(params, batch.L1[i], batch.L2[i], q1, q2, dq1, dq2);
+
+        float rhs1 = batch.torque1[i] - terms.bias1;
+        float rhs2 = batch.torque2[i] - terms.bias2;
+        float inverseDet = 1.0f / (terms.m11 * terms.m22 - terms.m12 * terms.m12); // M is positive definite for positive masses
+        float ddq1 = (terms.m22 * rhs1 - terms.m12 * rhs2) * inverseDet;
+        float ddq2 = (terms.m11 * rhs2 - terms.m12 * rhs1) * inverseDet;
+
+        dq1 += ddq1 * dt;
+        dq2 += ddq2 * dt;
+        batch.velocity1[i] = dq1;
+        batch.velocity2[i] = dq2;
+        batch.angle1[i] = q1 + dq1 * dt;
+        batch.angle2[i] = q2 + dq2 * dt;
+    }
+}
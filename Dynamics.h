@@ -0,0 +1,59 @@
+#ifndef DYNAMICS_HPP
+#define DYNAMICS_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Joint control law of the servo
+enum class ControlLaw {
+    Pd,            // PD on position and velocity error plus gravity compensation
+    Pid,           // PD plus an integral term that removes the steady-state error of friction and model error
+    ComputedTorque // Inverse dynamics of the reference acceleration plus PD, for a fixed closed-loop bandwidth
+};
+
+// Mass properties, friction and motors of the two-link arm. SI units; link
+// lengths stay in pixels everywhere else and are scaled by metersPerPixel.
+struct DynamicsParams {
+    float metersPerPixel = 0.005f; // 100 px links are 0.5 m long
+    float m1 = 2.0f, m2 = 1.0f;    // Link masses (kg)
+    float com1 = 0.5f, com2 = 0.5f; // Centre of mass along each link, as a fraction of its length
+    float payload = 0.0f;          // Point mass at the end effector (kg)
+    float gravity = 9.81f;         // Along +y, which points down the screen (m/s^2)
+    float viscous1 = 0.05f, viscous2 = 0.05f; // Viscous joint friction (N m s/rad)
+    float coulomb1 = 0.1f, coulomb2 = 0.1f;   // Coulomb joint friction (N m)
+    float kp1 = 400, kp2 = 200;    // Joint servo stiffness (N m/rad)
+    float kd1 = 40, kd2 = 20;      // Joint servo damping (N m s/rad)
+    float ki1 = 800, ki2 = 400;    // Integral gains, Pid only (N m/(rad s))
+    float integralLimit = 0.02f;   // Anti-windup bound of the integrated error (rad s)
+    float bandwidth = 40;          // Closed-loop natural frequency, ComputedTorque only (rad/s)
+    ControlLaw law = ControlLaw::Pd;
+    float dt = 0.001f;             // Simulated time per step (s)
+    float defaultMaxTorque1 = 30, defaultMaxTorque2 = 10; // Motor torque limits of new batch entries (N m)
+};
+
+// A batch of arms in structure-of-arrays layout, one entry per arm in each array
+struct DynamicsBatch {
+    std::vector<float> L1, L2;                 // Link lengths (m)
+    std::vector<float> maxTorque1, maxTorque2; // Motor torque limits (N m)
+    std::vector<float> angle1, angle2;         // Joint angles (rad)
+    std::vector<float> velocity1, velocity2;   // Joint velocities (rad/s)
+    std::vector<float> setpoint1, setpoint2;   // Servo setpoints (rad)
+    std::vector<float> setpointVelocity1, setpointVelocity2;         // Rate of change of the setpoints (rad/s)
+    std::vector<float> setpointAcceleration1, setpointAcceleration2; // ComputedTorque feedforward (rad/s^2)
+    std::vector<float> integral1, integral2;   // Integrated position error, Pid only (rad s)
+    std::vector<float> torque1, torque2;       // Motor torques applied in the last step (N m)
+
+    size_t size() const { return angle1.size(); }
+    void resize(size_t count);
+};
+
+// Function to compute the joint torques that hold an arm still against gravity
+void gravityTorques(const DynamicsParams& params, float L1, float L2, float angle1, float angle2, float& torque1, float& torque2);
+
+// Function to set the motor torques of arms [begin, end) with params.law, clamped to the motors
+void servoTorques(DynamicsBatch& batch, const DynamicsParams& params, size_t begin, size_t end);
+
+// Function to advance arms [begin, end) by one semi-implicit Euler step of params.dt under their motor torques
+void stepDynamics(DynamicsBatch& batch, const DynamicsParams& params, size_t begin, size_t end);
+
+#endif // DYNAMICS_HPP
@@ -0,0 +1,70 @@
+#ifndef FASTMATH_HPP
+#define FASTMATH_HPP
+
+#include <cstdint>
+#include <cstring>
+
+/*
+ * Approximate math kernels for the fast solver variant. Error bounds are for
+ * float inputs in the stated domain; the accuracy harness measures what they
+ * mean in pixels.
+ */
+
+// 1/sqrt(x) for x > 0: bit-trick seed plus two Newton steps, relative error ~5e-6
+inline float fastRsqrt(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5F375A86u - (bits >> 1);
+    float y;
+    std::memcpy(&y, &bits, sizeof(y));
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y;
+}
+
+// sqrt(x) for x >= 0
+inline float fastSqrt(float x) {
+    return x > 0 ? x * fastRsqrt(x) : 0.0f;
+}
+
+// atan2(y, x): minimax polynomial for atan on [0, 1] plus octant folding, |error| < 1e-5 rad
+inline float fastAtan2(float y, float x) {
+    float ax = x < 0 ? -x : x;
+    float ay = y < 0 ? -y : y;
+    float mx = ax > ay ? ax : ay;
+    float mn = ax > ay ? ay : ax;
+    if (mx == 0) return 0.0f;
+
+    float z = mn / mx;
+    float z2 = z * z;
+    float r = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+    if (ay > ax) r = 1.57079637f - r;
+    if (x < 0) r = 3.14159274f - r;
+    return y < 0 ? -r : r;
+}
+
+// acos(x) for x in [-1, 1]: Abramowitz & Stegun 4.4.46, |error| < 2e-8 rad before rounding
+inline float fastAcos(float x) {
+    float ax = x < 0 ? -x : x;
+    float p = 1.5707963050f + ax * (-0.2145988016f + ax * (0.0889789874f + ax * (-0.0501743046f
+              + ax * (0.0308918810f + ax * (-0.0170881256f + ax * (0.0066700901f + ax * -0.0012624911f))))));
+    float r = fastSqrt(1.0f - ax) * p;
+    return x < 0 ? 3.14159274f - r : r;
+}
+
+// sin(x) and cos(x) for |x| < 1e4: reduction to [-pi/2, pi/2] and Taylor polynomials, |error| < 3e-7.
+// Branch-free, so loops over arrays of angles vectorize.
+inline void fastSinCos(float x, float& s, float& c) {
+    float k = x * 0.318309886f;          // x / pi
+    k = (k + 12582912.0f) - 12582912.0f; // Round to nearest: 1.5 * 2^23 pushes the fraction out of the mantissa
+    float r = ((x - k * 3.140625f) - k * 9.67502593994140625e-4f) - k * 1.509957990978376432e-7f; // Cody-Waite split of pi
+    int32_t quadrant = static_cast<int32_t>(k);
+    float sign = static_cast<float>(1 - 2 * (quadrant & 1));
+    float r2 = r * r;
+    s = sign * r * (1.0f + r2 * (-1.66666667e-1f + r2 * (8.33333333e-3f + r2 * (-1.98412698e-4f
+        + r2 * (2.75573192e-6f + r2 * -2.50521084e-8f)))));
+    c = sign * (1.0f + r2 * (-0.5f + r2 * (4.16666667e-2f + r2 * (-1.38888889e-3f + r2 * (2.48015873e-5f
+        + r2 * (-2.75573192e-7f + r2 * 2.08767570e-9f))))));
+}
+
+#endif // FASTMATH_HPP
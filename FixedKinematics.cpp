@@ -0,0 +1,311 @@
+#include "FixedKinematics.h"
+
+#include <bit>
+
+namespace {
+
+// atan(2^-i) in Q2.30, i = 0..30
+constexpr int32_t kAtanTable[31] = {
+    843314857, 497837829, 263043837, 133525159, 67021687, 33543516, 16775851, 8388437,
+    4194283, 2097149, 1048576, 524288, 262144, 131072, 65536, 32768,
+    16384, 8192, 4096, 2048, 1024, 512, 256, 128,
+    64, 32, 16, 8, 4, 2, 1,
+};
+
+const int32_t kPiQ29 = 1686629713;          // pi in Q3.29
+const int32_t kCircularGainQ30 = 652032874; // prod 1 / sqrt(1 + 2^-2i), i = 0..30, in Q1.30
+const int32_t kHyperbolicGainQ30 = 1296540104; // 1 / prod sqrt(1 - 2^-2i) over kHyperbolicSteps, in Q2.30
+
+// Hyperbolic CORDIC converges only if steps 4 and 13 are repeated
+const int kHyperbolicSteps[] = {1, 2, 3, 4, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 13, 14,
+                                15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29};
+
+const int32_t kOneQ30 = 1 << 30;
+
+// Shift right by `shift` bits, rounding half up
+int32_t roundShift(int64_t value, int shift) {
+    return static_cast<int32_t>((value + (int64_t(1) << (shift - 1))) >> shift);
+}
+
+// a * b for b in Q1.30; the result has the Q format of a
+int32_t mulQ30(int32_t a, int32_t b) {
+    return roundShift(static_cast<int64_t>(a) * b, 30);
+}
+
+// kAtanTable converted to AngleFrac fraction bits, at compile time
+template <int AngleFrac>
+struct AtanSteps {
+    int32_t step[31];
+
+    constexpr AtanSteps() : step() {
+        for (int i = 0; i < 31; ++i) {
+            step[i] = static_cast<int32_t>((kAtanTable[i] + (int64_t(1) << (29 - AngleFrac))) >> (30 - AngleFrac));
+        }
+    }
+};
+
+template <int AngleFrac>
+constexpr AtanSteps<AngleFrac> kAtanSteps;
+
+// value for mask 0, -value for mask -1: the direction of a CORDIC step without a branch
+int32_t applySign(int32_t value, int32_t mask) {
+    return (value ^ mask) - mask;
+}
+
+template <int AngleFrac>
+int32_t piFixed() {
+    return roundShift(kPiQ29, 29 - AngleFrac);
+}
+
+// num / den as Q1.30 for |num| <= den: restoring division, one quotient bit per step
+int32_t divideQ30(int64_t num, int64_t den) {
+    uint64_t remainder = static_cast<uint64_t>(num < 0 ? -num : num);
+    uint64_t divisor = static_cast<uint64_t>(den);
+    int32_t quotient = 0;
+    for (int bit = 0; bit <= 30; ++bit) {
+        quotient <<= 1;
+        if (remainder >= divisor) {
+            remainder -= divisor;
+            quotient |= 1;
+        }
+        remainder <<= 1;
+    }
+    return num < 0 ? -quotient : quotient;
+}
+
+} // namespace
+
+/**
+ * Function to compute sin and cos of a fixed-point angle.
+ *
+ * Reduces the angle to [-pi/2, pi/2], where rotation-mode CORDIC converges,
+ * and rotates the gain-compensated unit vector towards it one table angle per
+ * step. AngleFrac + 1 steps resolve the last bit of the angle.
+ *
+ * @param angle The angle, with AngleFrac fraction bits.
+ * @param sine The sine, in Q1.30 (output).
+ * @param cosine The cosine, in Q1.30 (output).
+ * @return none
+ */
+template <int AngleFrac>
+void cordicSinCos(int32_t angle, int32_t& sine, int32_t& cosine) {
+    const int32_t pi = piFixed<AngleFrac>();
+    const int32_t halfPi = pi / 2;
+
+    while (angle > pi) angle -= 2 * pi;
+    while (angle < -pi) angle += 2 * pi;
+    bool negate = false;
+    if (angle > halfPi) {
+        angle -= pi;
+        negate = true;
+    } else if (angle < -halfPi) {
+        angle += pi;
+        negate = true;
+    }
+
+    int32_t x = kCircularGainQ30, y = 0, z = angle;
+    for (int i = 0; i <= AngleFrac && i <= 30; ++i) {
+        int32_t direction = z >> 31; // Rotate towards z: 0 if z >= 0, -1 otherwise
+        int32_t dx = y >> i, dy = x >> i;
+        x -= applySign(dx, direction);
+        y += applySign(dy, direction);
+        z -= applySign(kAtanSteps<AngleFrac>.step[i], direction);
+    }
+    sine = negate ? -y : y;
+    cosine = negate ? -x : x;
+}
+
+/**
+ * Function to compute atan2 with vectoring-mode CORDIC.
+ *
+ * The vector is scaled to 29 significant bits, so inputs of any magnitude use
+ * the full precision and the growth of CORDIC (1.65x) cannot overflow, then
+ * rotated onto the positive x-axis while the rotation angles are summed.
+ *
+ * @param y The y-component.
+ * @param x The x-component.
+ * @return The angle of (x, y) in [-pi, pi], with AngleFrac fraction bits; 0 for (0, 0).
+ */
+template <int AngleFrac>
+int32_t cordicAtan2(int32_t y, int32_t x) {
+    int64_t ax = x < 0 ? -static_cast<int64_t>(x) : x;
+    int64_t ay = y < 0 ? -static_cast<int64_t>(y) : y;
+    if (y == 0) return x < 0 ? piFixed<AngleFrac>() : 0;
+
+    // Scale so the larger component has 29 bits
+    int shift = 29 - std::bit_width(static_cast<uint64_t>(ax > ay ? ax : ay));
+    int64_t vx = shift >= 0 ? static_cast<int64_t>(x) << shift : static_cast<int64_t>(x) >> -shift;
+    int64_t vy = shift >= 0 ? static_cast<int64_t>(y) << shift : static_cast<int64_t>(y) >> -shift;
+
+    // Left half-plane: rotate by pi first
+    int32_t z = 0;
+    if (vx < 0) {
+        z = vy >= 0 ? piFixed<AngleFrac>() : -piFixed<AngleFrac>();
+        vx = -vx;
+        vy = -vy;
+    }
+
+    int32_t cx = static_cast<int32_t>(vx), cy = static_cast<int32_t>(vy);
+    for (int i = 0; i <= AngleFrac && i <= 30; ++i) {
+        int32_t direction = cy >> 31; // Rotate towards the x-axis: 0 if cy >= 0, -1 otherwise
+        int32_t dx = cy >> i, dy = cx >> i;
+        cx += applySign(dx, direction);
+        cy -= applySign(dy, direction);
+        z += applySign(kAtanSteps<AngleFrac>.step[i], direction);
+    }
+    return z;
+}
+
+/**
+ * Function to compute a square root with hyperbolic vectoring-mode CORDIC.
+ *
+ * The value is scaled by a power of 4 into [0.5, 2), where the iteration
+ * converges; hyperbolic vectoring of (v + 1/4, v - 1/4) leaves
+ * gain * sqrt(v) in x, and the power of 2 is shifted back out.
+ *
+ * @param value The value, in Q2.30.
+ * @return The square root, in Q2.30.
+ */
+uint32_t cordicSqrt(uint32_t value) {
+    if (value == 0) return 0;
+
+    // value = m * 4^-k with m in [0.5, 2)
+    int k = (31 - std::bit_width(value)) >> 1; // Rounded down, so m has 30 or 31 bits
+    uint32_t m = k >= 0 ? value << (2 * k) : value >> (-2 * k);
+
+    // Q2.29 from here, so x stays below 4
+    int32_t half = static_cast<int32_t>(m >> 1);
+    int32_t x = half + (1 << 27), y = half - (1 << 27);
+    for (int i : kHyperbolicSteps) {
+        int32_t direction = y >> 31;
+        int32_t dx = y >> i, dy = x >> i;
+        x -= applySign(dx, direction);
+        y -= applySign(dy, direction);
+    }
+    int64_t root = static_cast<int64_t>(roundShift(static_cast<int64_t>(x) * kHyperbolicGainQ30, 30)) << 1; // Q2.30
+    return static_cast<uint32_t>(k >= 0 ? root >> k : root << -k);
+}
+
+/**
+ * Function to calculate both solutions of the two-link arm in fixed point.
+ *
+ * The reach test compares exact 64-bit squared distances, so it agrees with
+ * the geometry to the last bit. The cosine of angle2 comes from the law of
+ * cosines by integer division, its sine from cordicSqrt, and every angle from
+ * cordicAtan2.
+ *
+ * @param px The x-coordinate of the arm's pivot point.
+ * @param py The y-coordinate of the arm's pivot point.
+ * @param tx The x-coordinate of the target point.
+ * @param ty The y-coordinate of the target point.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param up The elbow-up solution (output, only written on success).
+ * @param down The elbow-down solution (output, only written on success).
+ * @return IkResult::Ok if the target is reachable.
+ */
+template <typename Format>
+IkResult solveArmConfigurationsFixed(int32_t px, int32_t py, int32_t tx, int32_t ty, int32_t L1, int32_t L2,
+                                     FixedArmSolution& up, FixedArmSolution& down) {
+    constexpr int A = Format::kAngleFrac;
+
+    int32_t dx = tx - px;
+    int32_t dy = ty - py;
+    int64_t distance2 = static_cast<int64_t>(dx) * dx + static_cast<int64_t>(dy) * dy;
+    int64_t reach = static_cast<int64_t>(L1) + L2;
+    int64_t innerReach = static_cast<int64_t>(L1) - L2;
+    if (distance2 > reach * reach || distance2 < innerReach * innerReach) {
+        return IkResult::OutOfReach;
+    }
+
+    int64_t numerator = distance2 - static_cast<int64_t>(L1) * L1 - static_cast<int64_t>(L2) * L2;
+    int64_t denominator = 2 * static_cast<int64_t>(L1) * L2;
+    if (denominator <= 0 || numerator > denominator || numerator < -denominator) {
+        return IkResult::InvalidTarget;
+    }
+
+    int32_t cosAngle2 = divideQ30(numerator, denominator);
+    int64_t sin2Squared = (static_cast<int64_t>(kOneQ30) << 30) - static_cast<int64_t>(cosAngle2) * cosAngle2;
+    int32_t sinAngle2 = static_cast<int32_t>(cordicSqrt(static_cast<uint32_t>(sin2Squared >> 30)));
+    int32_t angle2 = cordicAtan2<A>(sinAngle2, cosAngle2);
+
+    int32_t direction = cordicAtan2<A>(dy, dx);
+    int32_t k1 = L1 + mulQ30(L2, cosAngle2);
+    int32_t k2 = mulQ30(L2, sinAngle2);
+
+    up = {direction - cordicAtan2<A>(k2, k1), angle2};
+    down = {direction - cordicAtan2<A>(-k2, k1), -angle2};
+    return IkResult::Ok;
+}
+
+/**
+ * Function to compute the joint positions from the joint angles in fixed point.
+ *
+ * @param px The x-coordinate of the arm's pivot point.
+ * @param py The y-coordinate of the arm's pivot point.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param angle1 The angle of the first joint.
+ * @param angle2 The angle of the second joint, relative to the first segment.
+ * @param x2 The x-coordinate of the elbow (output).
+ * @param y2 The y-coordinate of the elbow (output).
+ * @param x3 The x-coordinate of the end effector (output).
+ * @param y3 The y-coordinate of the end effector (output).
+ * @return none
+ */
+template <typename Format>
+void forwardKinematicsFixed(int32_t px, int32_t py, int32_t L1, int32_t L2, int32_t angle1, int32_t angle2,
+                            int32_t& x2, int32_t& y2, int32_t& x3, int32_t& y3) {
+    int32_t s1, c1, s12, c12;
+    cordicSinCos<Format::kAngleFrac>(angle1, s1, c1);
+    cordicSinCos<Format::kAngleFrac>(angle1 + angle2, s12, c12);
+    x2 = px + mulQ30(L1, c1);
+    y2 = py + mulQ30(L1, s1);
+    x3 = x2 + mulQ30(L2, c12);
+    y3 = y2 + mulQ30(L2, s12);
+}
+
+/**
+ * Function to solve a float target with the controllers' fixed-point solver.
+ *
+ * The inputs are rounded to FixedQ12 as the controller would receive them and
+ * the angles converted back, so the simulator and the benchmarks see exactly
+ * the controllers' results.
+ *
+ * @param px The x-coordinate of the arm's pivot point.
+ * @param py The y-coordinate of the arm's pivot point.
+ * @param tx The x-coordinate of the target point.
+ * @param ty The y-coordinate of the target point.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param up The elbow-up solution (output, only written on success).
+ * @param down The elbow-down solution (output, only written on success).
+ * @return IkResult::Ok if the target is reachable.
+ */
+IkResult solveArmConfigurationsCordic(float px, float py, float tx, float ty, float L1, float L2, ArmSolution& up, ArmSolution& down) {
+    FixedArmSolution fixedUp, fixedDown;
+    IkResult result = solveArmConfigurationsFixed<FixedQ12>(
+        toFixedLength<FixedQ12>(px), toFixedLength<FixedQ12>(py), toFixedLength<FixedQ12>(tx),
+        toFixedLength<FixedQ12>(ty), toFixedLength<FixedQ12>(L1), toFixedLength<FixedQ12>(L2), fixedUp, fixedDown);
+    if (result != IkResult::Ok) return result;
+
+    up = {fromFixedAngle<FixedQ12>(fixedUp.angle1), fromFixedAngle<FixedQ12>(fixedUp.angle2)};
+    down = {fromFixedAngle<FixedQ12>(fixedDown.angle1), fromFixedAngle<FixedQ12>(fixedDown.angle2)};
+    return IkResult::Ok;
+}
+
+// The formats the controllers use; other formats do not link
+template void cordicSinCos<FixedQ12::kAngleFrac>(int32_t, int32_t&, int32_t&);
+template void cordicSinCos<FixedQ8::kAngleFrac>(int32_t, int32_t&, int32_t&);
+template int32_t cordicAtan2<FixedQ12::kAngleFrac>(int32_t, int32_t);
+template int32_t cordicAtan2<FixedQ8::kAngleFrac>(int32_t, int32_t);
+
+template IkResult solveArmConfigurationsFixed<FixedQ12>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t,
+                                                        FixedArmSolution&, FixedArmSolution&);
+template IkResult solveArmConfigurationsFixed<FixedQ8>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t,
+                                                       FixedArmSolution&, FixedArmSolution&);
+
+template void forwardKinematicsFixed<FixedQ12>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t,
+                                               int32_t&, int32_t&, int32_t&, int32_t&);
+template void forwardKinematicsFixed<FixedQ8>(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t,
+                                              int32_t&, int32_t&, int32_t&, int32_t&);
@@ -0,0 +1,87 @@
+#ifndef FIXEDKINEMATICS_HPP
+#define FIXEDKINEMATICS_HPP
+
+#include <cmath>
+#include <cstdint>
+#include "Kinematics.h"
+
+/*
+ * Integer-only two-link kinematics, as run by the arm controllers (no FPU).
+ *
+ * Lengths and positions are int32 with Format::kLengthFrac fraction bits,
+ * angles are int32 radians with Format::kAngleFrac fraction bits, and sines,
+ * cosines and unit ratios are Q1.30. atan2, sin/cos and sqrt are CORDIC
+ * iterations over constant integer tables; the only other operations are
+ * adds, shifts, multiplies and a shift-and-subtract division. Nothing depends
+ * on the compiler or the CPU (C++20 defines >> of negative values as
+ * arithmetic), so a controller build and a host build of this file return
+ * identical bits for identical inputs.
+ */
+
+// Q format of a fixed-point solver; angles need 4 integer bits for the sums of two joint angles
+template <int LengthFrac, int AngleFrac>
+struct FixedFormat {
+    static_assert(LengthFrac >= 0 && LengthFrac <= 20, "lengths need at least 11 integer bits");
+    static_assert(AngleFrac >= 8 && AngleFrac <= 27, "angles need 4 integer bits and at least 8 fraction bits");
+    static constexpr int kLengthFrac = LengthFrac;
+    static constexpr int kAngleFrac = AngleFrac;
+};
+
+using FixedQ12 = FixedFormat<12, 27>; // Q19.12 lengths, Q4.27 angles: the controller default
+using FixedQ8 = FixedFormat<8, 20>;   // Q23.8 lengths, Q11.20 angles: fewer CORDIC iterations
+
+// One joint-space solution in the angle format of the solver
+struct FixedArmSolution {
+    int32_t angle1;
+    int32_t angle2;
+};
+
+// Function to convert a length in pixels to fixed point (host side; controllers receive fixed point)
+template <typename Format>
+int32_t toFixedLength(float value) {
+    return static_cast<int32_t>(std::lround(std::ldexp(static_cast<double>(value), Format::kLengthFrac)));
+}
+
+// Function to convert an angle in radians to fixed point
+template <typename Format>
+int32_t toFixedAngle(float value) {
+    return static_cast<int32_t>(std::lround(std::ldexp(static_cast<double>(value), Format::kAngleFrac)));
+}
+
+// Function to convert a fixed-point length back to pixels
+template <typename Format>
+float fromFixedLength(int32_t value) {
+    return static_cast<float>(std::ldexp(static_cast<double>(value), -Format::kLengthFrac));
+}
+
+// Function to convert a fixed-point angle back to radians
+template <typename Format>
+float fromFixedAngle(int32_t value) {
+    return static_cast<float>(std::ldexp(static_cast<double>(value), -Format::kAngleFrac));
+}
+
+// Function to compute sin and cos (Q1.30) of an angle with AngleFrac fraction bits
+template <int AngleFrac>
+void cordicSinCos(int32_t angle, int32_t& sine, int32_t& cosine);
+
+// Function to compute atan2(y, x) with AngleFrac fraction bits; x and y share any Q format
+template <int AngleFrac>
+int32_t cordicAtan2(int32_t y, int32_t x);
+
+// Function to compute sqrt(value) for a Q2.30 value (below 4), as Q2.30
+uint32_t cordicSqrt(uint32_t value);
+
+// Function to compute both solutions of the two-link arm in fixed point
+template <typename Format>
+IkResult solveArmConfigurationsFixed(int32_t px, int32_t py, int32_t tx, int32_t ty, int32_t L1, int32_t L2,
+                                     FixedArmSolution& up, FixedArmSolution& down);
+
+// Function to compute the elbow (x2, y2) and end effector (x3, y3) in fixed point
+template <typename Format>
+void forwardKinematicsFixed(int32_t px, int32_t py, int32_t L1, int32_t L2, int32_t angle1, int32_t angle2,
+                            int32_t& x2, int32_t& y2, int32_t& x3, int32_t& y3);
+
+// Same as solveArmConfigurations, rounding the inputs to FixedQ12 and solving them like a controller
+IkResult solveArmConfigurationsCordic(float px, float py, float tx, float ty, float L1, float L2, ArmSolution& up, ArmSolution& down);
+
+#endif // FIXEDKINEMATICS_HPP
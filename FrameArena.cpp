@@ -0,0 +1,61 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kDefaultArenaBytes = 64 * 1024; // A frame of a few hundred arms, before any growth
+
+} // namespace
+
+FrameArena::FrameArena(size_t capacity) : block(capacity) {}
+
+/**
+ * Function to carve a piece out of the arena.
+ *
+ * @param bytes The size of the piece.
+ * @param alignment The alignment of the piece, a power of two.
+ * @return The piece, valid until the arena is reset or rewound past it.
+ */
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data());
+    size_t offset = ((base + used + alignment - 1) & ~(alignment - 1)) - base;
+    if (offset + bytes <= block.size()) {
+        used = offset + bytes;
+        peak = std::max(peak, used + spillBytes);
+        return block.data() + offset;
+    }
+
+    // Does not fit: spill to the heap until the next reset grows the block
+    spills.push_back(std::make_unique<std::byte[]>(bytes + alignment));
+    ++spilled;
+    spillBytes += bytes + alignment;
+    peak = std::max(peak, used + spillBytes);
+    std::uintptr_t spill = reinterpret_cast<std::uintptr_t>(spills.back().get());
+    return reinterpret_cast<void*>((spill + alignment - 1) & ~(alignment - 1));
+}
+
+/**
+ * Function to release everything allocated since a marker was taken.
+ *
+ * Rewinding to an empty arena (reset(), or a Scope opened on one) after a
+ * frame that spilled replaces the block with one that holds that frame whole.
+ *
+ * @param marker The position to return to.
+ * @return none
+ */
+void FrameArena::rewind(Marker marker) {
+    used = std::min(used, marker.used);
+    if (spills.size() > marker.spills) {
+        spills.resize(marker.spills);
+        spillBytes = marker.spillBytes;
+    }
+    if (marker.used == 0 && marker.spills == 0 && peak > block.size()) {
+        block = std::vector<std::byte>(peak);
+    }
+}
+
+FrameArena& frameArena() {
+    thread_local FrameArena arena(kDefaultArenaBytes);
+    return arena;
+}
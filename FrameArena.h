@@ -0,0 +1,113 @@
+#ifndef FRAMEARENA_HPP
+#define FRAMEARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * Bump allocator for memory that lives at most one frame.
+ *
+ * allocate() hands out consecutive pieces of one block and never frees them
+ * individually; reset() at the start of every frame reclaims everything, and a
+ * Scope rewinds to where it was opened, for scratch that dies sooner. A frame
+ * that needs more than the block spills into extra heap blocks; the next
+ * rewind to an empty arena (reset(), or the outermost Scope on threads that
+ * never reset) replaces the block with one big enough for that frame, so
+ * steady state frames allocate nothing.
+ *
+ * Each thread has its own arena (frameArena()). Memory handed out by
+ * allocate() is raw: nothing placed there is ever destroyed, so only
+ * trivially destructible types belong there, unless a container (ArenaVector)
+ * destroys them.
+ */
+class FrameArena {
+public:
+    // Position of the arena, to rewind to
+    struct Marker {
+        size_t used;
+        size_t spills;
+        size_t spillBytes;
+    };
+
+    // Rewinds the arena to where it was when the scope was opened
+    class Scope {
+    public:
+        explicit Scope(FrameArena& arena) : arena(arena), marker(arena.mark()) {}
+        ~Scope() { arena.rewind(marker); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameArena& arena;
+        Marker marker;
+    };
+
+    explicit FrameArena(size_t capacity);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment);
+
+    // Uninitialized storage for `count` objects of type T
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    Marker mark() const { return {used, spills.size(), spillBytes}; }
+    void rewind(Marker marker);
+    void reset() { rewind({0, 0, 0}); }
+
+    size_t capacity() const { return block.size(); }
+    size_t highWater() const { return peak; }
+    uint64_t spillCount() const { return spilled; } // Allocations that did not fit the block, since construction
+
+private:
+    std::vector<std::byte> block;
+    size_t used = 0;
+    size_t spillBytes = 0; // Bytes held by the live spills
+    size_t peak = 0;       // Most bytes one frame has used
+    uint64_t spilled = 0;
+    std::vector<std::unique_ptr<std::byte[]>> spills;
+};
+
+// Function to get the calling thread's frame arena
+FrameArena& frameArena();
+
+/**
+ * Standard allocator over a frame arena, for containers that hold per-frame
+ * scratch. deallocate() is a no-op; the memory comes back when the arena is
+ * reset or rewound, so such a container must not outlive that.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() : arena(&frameArena()) {}
+    explicit ArenaAllocator(FrameArena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) { return arena->allocate<T>(count); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    FrameArena* arena;
+};
+
+// A vector whose storage comes from the frame arena
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // FRAMEARENA_HPP
@@ -0,0 +1,186 @@
+#include "FrameBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "AllocCounter.h"
+#include "FrameArena.h"
+#include "Log.h"
+#include "RoboticArm.h"
+#include "Simulation.h"
+
+namespace {
+
+constexpr unsigned kWidth = 1600, kHeight = 1200;
+
+struct Scenario {
+    const char* name;
+    int armCount;
+    int itemCount;
+    bool retarget; // give every arm a new target every frame
+};
+
+const Scenario kScenarios[] = {
+    {"single_arm", 1, 0, false},
+    {"arms_100", 100, 0, false},
+    {"arms_1000_items", 1000, 10000, false},
+    {"retarget", 100, 0, true},
+};
+
+// Arms on a regular lattice covering the render target, small enough not to overlap much
+std::vector<ArmState> layoutArms(int count) {
+    int columns = static_cast<int>(std::ceil(std::sqrt(count * static_cast<double>(kWidth) / kHeight)));
+    int rows = (count + columns - 1) / columns;
+    float cellW = static_cast<float>(kWidth) / columns, cellH = static_cast<float>(kHeight) / rows;
+    float link = std::max(4.0f, std::min(cellW, cellH) * 0.35f);
+
+    std::vector<ArmState> arms(count);
+    for (int i = 0; i < count; ++i) {
+        ArmState& arm = arms[i];
+        arm.px = arm.tx = (i % columns + 0.5f) * cellW;
+        arm.py = arm.ty = (i / columns + 0.5f) * cellH;
+        arm.L1 = link;
+        arm.L2 = link * 0.8f;
+    }
+    return arms;
+}
+
+// A reachable target in the arm's annulus
+void randomTarget(const ArmState& arm, std::mt19937& rng, float& x, float& y) {
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+    std::uniform_real_distribution<float> distance(std::fabs(arm.L1 - arm.L2) + 1, arm.L1 + arm.L2 - 1);
+    float a = angle(rng), d = distance(rng);
+    x = arm.px + d * std::cos(a);
+    y = arm.py + d * std::sin(a);
+}
+
+double percentile(std::vector<double> values, double p) {
+    size_t k = std::min(values.size() - 1, static_cast<size_t>(p * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<long>(k), values.end());
+    return values[k];
+}
+
+long peakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void runScenario(const Scenario& scenario, int frames, sf::RenderTexture& texture) {
+    SimulationParams params;
+    params.smoothFactor = 0.05f; // settle within the run so frames include real motion
+    std::vector<ArmState> arms = layoutArms(scenario.armCount);
+    std::mt19937 rng(1234);
+
+    // Static items scattered over the target, drawn as one batch like scene items
+    std::vector<SceneItem> sceneItems(scenario.itemCount);
+    std::uniform_real_distribution<float> ux(0, kWidth), uy(0, kHeight);
+    for (SceneItem& item : sceneItems) item = {ux(rng), uy(rng)};
+    sf::VertexArray itemVertices = makeItemVertices(sceneItems.data(), sceneItems.size());
+    items.clear();
+    itemGrabbed = false;
+    if (scenario.itemCount > 0) drawItem(static_cast<int>(arms[0].px + arms[0].L1), static_cast<int>(arms[0].py));
+
+    // Initial targets for every arm
+    for (ArmState& arm : arms) {
+        float x, y;
+        randomTarget(arm, rng, x, y);
+        retargetArm(arm, x, y, params);
+    }
+
+    std::vector<ArmCommand> noCommands;
+    std::vector<double> frameMs;
+    frameMs.reserve(frames);
+    uint64_t drawCalls = 0, vertices = 0;
+    int warmup = frames / 10; // Frames in which the arena, pools and vectors reach their working size
+    uint64_t allocationsBefore = 0;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        if (frame == warmup) allocationsBefore = heapAllocationCount();
+        auto start = std::chrono::steady_clock::now();
+        renderStats = RenderStats();
+        frameArena().reset();
+
+        if (scenario.retarget) {
+            for (ArmState& arm : arms) {
+                float x, y;
+                randomTarget(arm, rng, x, y);
+                retargetArm(arm, x, y, params);
+            }
+        }
+        tickArms(arms, noCommands, params);
+        drawScene(texture, arms, params, nullptr, 0, itemVertices, kWidth, kHeight);
+        texture.display();
+
+        frameMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        drawCalls += renderStats.drawCalls;
+        vertices += renderStats.vertices;
+    }
+
+    // key value lines in a fixed order, so runs of two builds can be diffed
+    std::printf("scenario %s\n", scenario.name);
+    std::printf("  frames %d\n", frames);
+    std::printf("  arms %d\n", scenario.armCount);
+    std::printf("  items %d\n", scenario.itemCount);
+    std::printf("  frame_ms_p50 %.3f\n", percentile(frameMs, 0.50));
+    std::printf("  frame_ms_p90 %.3f\n", percentile(frameMs, 0.90));
+    std::printf("  frame_ms_p99 %.3f\n", percentile(frameMs, 0.99));
+    std::printf("  frame_ms_max %.3f\n", *std::max_element(frameMs.begin(), frameMs.end()));
+    std::printf("  draw_calls_per_frame %llu\n", static_cast<unsigned long long>(drawCalls / frames));
+    std::printf("  vertices_per_frame %llu\n", static_cast<unsigned long long>(vertices / frames));
+    std::printf("  peak_rss_kb %ld\n", peakRssKb());
+    if (kCountsAllocations) {
+        // Debug builds only; zero unless a steady-state frame touched the heap
+        std::printf("  heap_allocs_per_frame %.3f\n", static_cast<double>(heapAllocationCount() - allocationsBefore)
+                                                         / static_cast<double>(frames - warmup));
+    }
+    std::fflush(stdout);
+}
+
+} // namespace
+
+/**
+ * Function to run a predefined frame-time scenario.
+ *
+ * Each scenario runs the same tick and drawScene() path as the window loop for
+ * a fixed number of frames, rendering into an offscreen texture so vsync and
+ * the compositor do not distort the numbers. Diagnostics below Error are muted
+ * while it runs. Peak RSS is process-wide, so run one scenario per process to
+ * compare memory. Debug builds also report the heap allocations per frame
+ * after a warm-up tenth of the run, which should be zero.
+ *
+ * @param scenario The scenario name, or "all".
+ * @param frames The number of frames to run.
+ * @return false if the scenario is unknown or no offscreen target is available.
+ */
+bool runFrameBenchmark(const std::string& scenario, int frames) {
+    if (frames <= 0) frames = 1;
+
+    sf::RenderTexture texture;
+    if (!texture.create(kWidth, kHeight)) {
+        logError("Cannot create an offscreen render target");
+        return false;
+    }
+
+    bool found = false;
+    LogLevel level = logLevel();
+    setLogLevel(LogLevel::Error);
+    for (const Scenario& candidate : kScenarios) {
+        if (scenario != "all" && scenario != candidate.name) continue;
+        found = true;
+        runScenario(candidate, frames, texture);
+    }
+    setLogLevel(level);
+
+    if (!found) {
+        std::string available;
+        for (const Scenario& candidate : kScenarios) available += std::string(candidate.name) + " ";
+        logError("Unknown scenario ", scenario, "; available: ", available, "all");
+    }
+    return found;
+}
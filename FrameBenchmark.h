@@ -0,0 +1,9 @@
+#ifndef FRAMEBENCHMARK_HPP
+#define FRAMEBENCHMARK_HPP
+
+#include <string>
+
+// Function to run a predefined frame-time scenario ("all" runs every scenario)
+bool runFrameBenchmark(const std::string& scenario, int frames);
+
+#endif // FRAMEBENCHMARK_HPP
@@ -0,0 +1,436 @@
+#include "Kinematics.h"
+#include "FastMath.h"
+#include "Log.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Function for linear interpolation between two values.
+ *
+ * This function computes a linear interpolation between two values based on the interpolation factor 't'.
+ *
+ * @param a The start value.
+ * @param b The end value.
+ * @param t The interpolation factor (between 0 and 1).
+ * @return The interpolated value.
+ */
+template <KinematicsScalar T>
+T lerp(T a, T b, T t) {
+    return a + (b - a) * t;
+}
+
+/**
+ * Function to compute the joint positions from the joint angles.
+ *
+ * @param px The x-coordinate of the arm's pivot point.
+ * @param py The y-coordinate of the arm's pivot point.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param angle1 The angle of the first joint.
+ * @param angle2 The angle of the second joint, relative to the first segment.
+ * @param x2 The x-coordinate of the elbow (output).
+ * @param y2 The y-coordinate of the elbow (output).
+ * @param x3 The x-coordinate of the end effector (output).
+ * @param y3 The y-coordinate of the end effector (output).
+ * @return none
+ */
+template <KinematicsScalar T>
+void forwardKinematics(T px, T py, T L1, T L2, T angle1, T angle2, T& x2, T& y2, T& x3, T& y3) {
+    using Ops = ScalarOps<T>;
+    x2 = px + L1 * Ops::cos(angle1);
+    y2 = py + L1 * Ops::sin(angle1);
+    x3 = x2 + L2 * Ops::cos(angle1 + angle2);
+    y3 = y2 + L2 * Ops::sin(angle1 + angle2);
+}
+
+/**
+ * Function to solve both joint-space solutions of a target without branching.
+ *
+ * The same law-of-cosines solution as solveArmConfigurations, written so that
+ * every lane of a FloatLanes value takes the same path: the cosine of angle2
+ * is clamped to [-1, 1] instead of rejecting the target, and the mask tells
+ * which targets were within reach.
+ *
+ * @param dx The x-offset of the target from the pivot.
+ * @param dy The y-offset of the target from the pivot.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param up The elbow-up solution (output).
+ * @param down The elbow-down solution (output).
+ * @return The reachable targets.
+ */
+template <KinematicsScalar T>
+typename ScalarOps<T>::Mask solveArmKernel(T dx, T dy, T L1, T L2, BasicArmSolution<T>& up, BasicArmSolution<T>& down) {
+    using Ops = ScalarOps<T>;
+
+    // Calculate the cosine of angle2 using the law of cosines
+    T cosAngle2 = (dx * dx + dy * dy - L1 * L1 - L2 * L2) / (T(2) * L1 * L2);
+    typename Ops::Mask reachable = (cosAngle2 >= T(-1)) & (cosAngle2 <= T(1));
+    cosAngle2 = Ops::min(Ops::max(cosAngle2, T(-1)), T(1));
+
+    // Calculate both possible angles for angle2 (elbow-up and elbow-down)
+    T angle2_ElbowUp = Ops::acos(cosAngle2);
+    T angle2_ElbowDown = -angle2_ElbowUp;
+
+    // Calculate the first angle (angle1) for both configurations. The elbow-down
+    // offset is the elbow-up one negated: sin, cos and atan2 are exactly
+    // symmetric in the sign of the angle, so this saves their evaluation.
+    T direction = Ops::atan2(dy, dx);
+    T k1 = L1 + L2 * Ops::cos(angle2_ElbowUp);
+    T k2 = L2 * Ops::sin(angle2_ElbowUp);
+    T offset = Ops::atan2(k2, k1);
+
+    up = {direction - offset, angle2_ElbowUp};
+    down = {direction + offset, angle2_ElbowDown};
+    return reachable;
+}
+
+/**
+ * Function to calculate both joint-space solutions for a target.
+ *
+ * This function uses inverse kinematics and the Law of Cosines to calculate
+ * the elbow-up and elbow-down angles that place the end effector on the target.
+ * It does not print anything, so it can be used in batch jobs. The solution
+ * itself is solveArmKernel's.
+ *
+ * @param px The x-coordinate of the arm's pivot point.
+ * @param py The y-coordinate of the arm's pivot point.
+ * @param tx The x-coordinate of the target point.
+ * @param ty The y-coordinate of the target point.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param up The elbow-up solution (output, only written on success).
+ * @param down The elbow-down solution (output, only written on success).
+ * @return IkResult::Ok if the target is reachable.
+ */
+template <KinematicsReal T>
+IkResult solveArmConfigurations(T px, T py, T tx, T ty, T L1, T L2, BasicArmSolution<T>& up, BasicArmSolution<T>& down) {
+    // Calculate the distance to the target
+    T dx = tx - px;
+    T dy = ty - py;
+    T distance = std::sqrt(dx * dx + dy * dy);
+
+    // Check if the target is within the reachable area
+    if (distance > L1 + L2 || distance < std::abs(L1 - L2)) {
+        return IkResult::OutOfReach;
+    }
+
+    // Rounding can still push the cosine of angle2 out of range near the boundary
+    if (!solveArmKernel(dx, dy, L1, L2, up, down)) {
+        return IkResult::InvalidTarget;
+    }
+    return IkResult::Ok;
+}
+
+/**
+ * Function to calculate both joint-space solutions with approximate math.
+ *
+ * Compares squared distances instead of taking a square root, uses
+ * cos(acos(c)) = c and sin(acos(c)) = sqrt(1 - c^2) instead of evaluating
+ * trigonometry on angle2, and replaces acos/atan2/sqrt with the polynomial and
+ * rsqrt kernels from FastMath.h. Use the accuracy harness to check the error
+ * for your link lengths before switching to it.
+ *
+ * @param px The x-coordinate of the arm's pivot point.
+ * @param py The y-coordinate of the arm's pivot point.
+ * @param tx The x-coordinate of the target point.
+ * @param ty The y-coordinate of the target point.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param up The elbow-up solution (output, only written on success).
+ * @param down The elbow-down solution (output, only written on success).
+ * @return IkResult::Ok if the target is reachable.
+ */
+IkResult solveArmConfigurationsFast(float px, float py, float tx, float ty, float L1, float L2, ArmSolution& up, ArmSolution& down) {
+    float dx = tx - px;
+    float dy = ty - py;
+    float distance2 = dx * dx + dy * dy;
+
+    float maxReach = L1 + L2;
+    float minReach = L1 - L2;
+    if (distance2 > maxReach * maxReach || distance2 < minReach * minReach) {
+        return IkResult::OutOfReach;
+    }
+
+    float cosAngle2 = (distance2 - L1 * L1 - L2 * L2) / (2 * L1 * L2);
+    if (cosAngle2 < -1 || cosAngle2 > 1) {
+        return IkResult::InvalidTarget;
+    }
+
+    float angle2 = fastAcos(cosAngle2);
+    float k1 = L1 + L2 * cosAngle2;
+    float k2 = L2 * fastSqrt(1.0f - cosAngle2 * cosAngle2);
+    float direction = fastAtan2(dy, dx);
+    float offset = fastAtan2(k2, k1);
+
+    // The elbow-down solution mirrors angle2 and the offset
+    up = {direction - offset, angle2};
+    down = {direction + offset, -angle2};
+    return IkResult::Ok;
+}
+
+/**
+ * Function to map an end-effector velocity to joint velocities.
+ *
+ * Inverts the analytic 2x2 Jacobian of the two-link arm with damped least
+ * squares, dq = (J^T J + lambda^2 I)^-1 J^T v. The damping is zero in the
+ * well-conditioned workspace and grows smoothly as |det J| = L1 L2 |sin(angle2)|
+ * drops towards zero, which happens at both singular boundaries (d = L1 + L2
+ * with the arm stretched, d = |L1 - L2| with it folded). Near them the arm
+ * slows down instead of spinning its joints.
+ *
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param angle1 The current angle of the first joint.
+ * @param angle2 The current angle of the second joint.
+ * @param vx The desired end-effector displacement along x for this step.
+ * @param vy The desired end-effector displacement along y for this step.
+ * @param dAngle1 The change of the first joint angle (output).
+ * @param dAngle2 The change of the second joint angle (output).
+ * @return none
+ */
+template <KinematicsReal T>
+void resolvedRateStep(T L1, T L2, T angle1, T angle2, T vx, T vy, T& dAngle1, T& dAngle2) {
+    T s1 = std::sin(angle1), c1 = std::cos(angle1);
+    T s12 = std::sin(angle1 + angle2), c12 = std::cos(angle1 + angle2);
+
+    // Jacobian of (x, y) with respect to (angle1, angle2)
+    T j11 = -L1 * s1 - L2 * s12, j12 = -L2 * s12;
+    T j21 = L1 * c1 + L2 * c12, j22 = L2 * c12;
+
+    // Adaptive damping: lambda^2 = lambda0^2 * (1 - w / w0)^2 below the manipulability threshold w0
+    T manipulability = std::abs(L1 * L2 * std::sin(angle2));
+    T threshold = T(0.1) * L1 * L2;
+    T lambda0 = T(0.1) * std::sqrt(L1 * L2);
+    T lambda2 = 0;
+    if (manipulability < threshold) {
+        T ratio = 1 - manipulability / threshold;
+        lambda2 = lambda0 * lambda0 * ratio * ratio;
+    }
+
+    // A = J^T J + lambda^2 I, b = J^T v
+    T a11 = j11 * j11 + j21 * j21 + lambda2;
+    T a12 = j11 * j12 + j21 * j22;
+    T a22 = j12 * j12 + j22 * j22 + lambda2;
+    T b1 = j11 * vx + j21 * vy;
+    T b2 = j12 * vx + j22 * vy;
+
+    T det = a11 * a22 - a12 * a12;
+    if (std::abs(det) < T(1e-12)) {
+        dAngle1 = dAngle2 = 0;
+        return;
+    }
+    dAngle1 = (a22 * b1 - a12 * b2) / det;
+    dAngle2 = (a11 * b2 - a12 * b1) / det;
+}
+
+/**
+ * Function to pick the equivalent angle closest to a reference.
+ *
+ * Adds the multiple of 2*pi that brings the angle nearest to the reference, so
+ * interpolating from the reference takes the short way round. With joint
+ * limits, the nearest equivalent inside [min, max] is used instead.
+ *
+ * @param angle The angle to unwrap (radians).
+ * @param reference The angle to stay close to, usually the current joint angle.
+ * @param min The lower joint limit (may be -infinity).
+ * @param max The upper joint limit (may be +infinity).
+ * @param unwrapped The unwrapped angle (output, only written on success).
+ * @return False if no equivalent angle lies within the limits.
+ */
+template <KinematicsReal T>
+bool unwrapAngle(T angle, T reference, T min, T max, T& unwrapped) {
+    const T twoPi = T(6.283185307179586);
+
+    T nearest = angle + std::round((reference - angle) / twoPi) * twoPi;
+    if (nearest >= min && nearest <= max) {
+        unwrapped = nearest;
+        return true;
+    }
+
+    // The reference is outside the limits or the short way is blocked: use the
+    // equivalent just inside whichever limit it is closest to
+    bool found = false;
+    T best = 0;
+    if (std::isfinite(min)) {
+        T above = std::max(min, angle + std::ceil((min - angle) / twoPi) * twoPi);
+        if (above <= max) {
+            best = above;
+            found = true;
+        }
+    }
+    if (std::isfinite(max)) {
+        T below = std::min(max, angle + std::floor((max - angle) / twoPi) * twoPi);
+        if (below >= min && (!found || std::abs(below - reference) < std::abs(best - reference))) {
+            best = below;
+            found = true;
+        }
+    }
+    if (found) unwrapped = best;
+    return found;
+}
+
+/**
+ * Function to choose the configuration with the shortest joint-space move.
+ *
+ * Both joints move at once, so a move takes as long as its slowest joint: the
+ * cost of a configuration is max(|delta1| / speed1, |delta2| / speed2), with
+ * each angle unwrapped towards the current one. Ties go to the smaller total
+ * joint motion. Configurations outside the joint limits are skipped.
+ *
+ * @param up The elbow-up solution.
+ * @param down The elbow-down solution.
+ * @param limits The joint limits and relative joint speeds.
+ * @param angle1 The current angle of the first joint; the chosen angle on success (input/output).
+ * @param angle2 The current angle of the second joint; the chosen angle on success (input/output).
+ * @param elbowUp The chosen configuration (output, only written on success).
+ * @param moveTime The cost of the chosen move, in radians at unit joint speed (output, only written on success).
+ * @return IkResult::Ok if a configuration was chosen, IkResult::OutsideLimits otherwise.
+ */
+template <KinematicsReal T>
+IkResult chooseArmConfiguration(const BasicArmSolution<T>& up, const BasicArmSolution<T>& down, const JointLimits& limits,
+                                T& angle1, T& angle2, bool& elbowUp, T& moveTime) {
+    const BasicArmSolution<T> solutions[2] = {up, down};
+    int best = -1;
+    T bestTime = 0, bestTotal = 0;
+    BasicArmSolution<T> chosen{};
+    for (int i = 0; i < 2; ++i) {
+        BasicArmSolution<T> candidate;
+        if (!unwrapAngle<T>(solutions[i].angle1, angle1, limits.min1, limits.max1, candidate.angle1)) continue;
+        if (!unwrapAngle<T>(solutions[i].angle2, angle2, limits.min2, limits.max2, candidate.angle2)) continue;
+
+        T time1 = std::abs(candidate.angle1 - angle1) / limits.speed1;
+        T time2 = std::abs(candidate.angle2 - angle2) / limits.speed2;
+        T time = std::max(time1, time2);
+        T total = time1 + time2;
+        if (best < 0 || time < bestTime - T(1e-6) || (time <= bestTime + T(1e-6) && total < bestTotal)) {
+            best = i;
+            bestTime = time;
+            bestTotal = total;
+            chosen = candidate;
+        }
+    }
+    if (best < 0) return IkResult::OutsideLimits;
+
+    angle1 = chosen.angle1;
+    angle2 = chosen.angle2;
+    elbowUp = best == 0;
+    moveTime = bestTime;
+    return IkResult::Ok;
+}
+
+/**
+ * Function to solve a target and choose the configuration with the shortest joint-space move.
+ *
+ * @param px The x-coordinate of the arm's pivot point.
+ * @param py The y-coordinate of the arm's pivot point.
+ * @param tx The x-coordinate of the target point.
+ * @param ty The y-coordinate of the target point.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param limits The joint limits and relative joint speeds.
+ * @param angle1 The current angle of the first joint; the chosen angle on success (input/output).
+ * @param angle2 The current angle of the second joint; the chosen angle on success (input/output).
+ * @param elbowUp The chosen configuration (output, only written on success).
+ * @param moveTime The cost of the chosen move, in radians at unit joint speed (output, only written on success).
+ * @return IkResult::Ok if a configuration was chosen.
+ */
+template <KinematicsReal T>
+IkResult selectArmConfiguration(T px, T py, T tx, T ty, T L1, T L2, const JointLimits& limits,
+                                T& angle1, T& angle2, bool& elbowUp, T& moveTime) {
+    BasicArmSolution<T> up, down;
+    IkResult result = solveArmConfigurations(px, py, tx, ty, L1, L2, up, down);
+    if (result != IkResult::Ok) return result;
+    return chooseArmConfiguration(up, down, limits, angle1, angle2, elbowUp, moveTime);
+}
+
+/**
+ * Function to count a solve in the metrics registry.
+ *
+ * @param result The outcome of the solve.
+ * @return none
+ */
+void countIkResult(IkResult result) {
+    static const char* help = "Inverse kinematics solves of new targets, by result.";
+    static Counter* const counters[] = {
+        &metrics().counter("arm_ik_solves_total{result=\"ok\"}", help),
+        &metrics().counter("arm_ik_solves_total{result=\"out_of_reach\"}", help),
+        &metrics().counter("arm_ik_solves_total{result=\"invalid_target\"}", help),
+        &metrics().counter("arm_ik_solves_total{result=\"outside_limits\"}", help),
+    };
+    counters[static_cast<int>(result)]->add();
+}
+
+/**
+ * Function to calculate the angles for the robotic arm's joints.
+ *
+ * This function uses inverse kinematics and the Law of Cosines to calculate
+ * the angles required for the robotic arm to reach a target point, choosing
+ * the configuration with the shortest unwrapped joint move (no joint limits).
+ *
+ * @param px The x-coordinate of the arm's pivot point.
+ * @param py The y-coordinate of the arm's pivot point.
+ * @param tx The x-coordinate of the target point.
+ * @param ty The y-coordinate of the target point.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param angle1 The current angle of the first joint; the calculated angle (input/output).
+ * @param angle2 The current angle of the second joint; the calculated angle (input/output).
+ * @param elbowUp The chosen configuration (output).
+ * @return none
+ */
+template <KinematicsReal T>
+void calculateArmAngles(T px, T py, T tx, T ty, T L1, T L2, T& angle1, T& angle2, bool& elbowUp) {
+    T moveTime;
+    IkResult result = selectArmConfiguration(px, py, tx, ty, L1, L2, JointLimits(), angle1, angle2, elbowUp, moveTime);
+    countIkResult(result);
+    if (result == IkResult::OutOfReach) {
+        logWarning("Target is out of reach!");
+        return;
+    }
+    if (result == IkResult::InvalidTarget) {
+        logWarning("Invalid target position");
+        return;
+    }
+}
+
+// The scalar types the kinematics are built for. Each is compiled here once and
+// checked by the compiler against the templates above; other types do not link.
+template float lerp(float, float, float);
+template double lerp(double, double, double);
+template FloatLanes lerp(FloatLanes, FloatLanes, FloatLanes);
+
+template void forwardKinematics(float, float, float, float, float, float, float&, float&, float&, float&);
+template void forwardKinematics(double, double, double, double, double, double, double&, double&, double&, double&);
+template void forwardKinematics(FloatLanes, FloatLanes, FloatLanes, FloatLanes, FloatLanes, FloatLanes,
+                                FloatLanes&, FloatLanes&, FloatLanes&, FloatLanes&);
+
+template bool solveArmKernel(float, float, float, float, BasicArmSolution<float>&, BasicArmSolution<float>&);
+template bool solveArmKernel(double, double, double, double, BasicArmSolution<double>&, BasicArmSolution<double>&);
+template LaneMask solveArmKernel(FloatLanes, FloatLanes, FloatLanes, FloatLanes, BasicArmSolution<FloatLanes>&,
+                                 BasicArmSolution<FloatLanes>&);
+
+template IkResult solveArmConfigurations(float, float, float, float, float, float, ArmSolution&, ArmSolution&);
+template IkResult solveArmConfigurations(double, double, double, double, double, double, BasicArmSolution<double>&,
+                                         BasicArmSolution<double>&);
+
+template void resolvedRateStep(float, float, float, float, float, float, float&, float&);
+template void resolvedRateStep(double, double, double, double, double, double, double&, double&);
+
+template bool unwrapAngle(float, float, float, float, float&);
+template bool unwrapAngle(double, double, double, double, double&);
+
+template IkResult chooseArmConfiguration(const ArmSolution&, const ArmSolution&, const JointLimits&, float&, float&, bool&,
+                                         float&);
+template IkResult chooseArmConfiguration(const BasicArmSolution<double>&, const BasicArmSolution<double>&, const JointLimits&,
+                                         double&, double&, bool&, double&);
+
+template IkResult selectArmConfiguration(float, float, float, float, float, float, const JointLimits&, float&, float&,
+                                         bool&, float&);
+template IkResult selectArmConfiguration(double, double, double, double, double, double, const JointLimits&, double&,
+                                         double&, bool&, double&);
+
+template void calculateArmAngles(float, float, float, float, float, float, float&, float&, bool&);
+template void calculateArmAngles(double, double, double, double, double, double, double&, double&, bool&);
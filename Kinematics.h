@@ -0,0 +1,80 @@
+#ifndef KINEMATICS_HPP
+#define KINEMATICS_HPP
+
+#include <limits>
+#include "ScalarOps.h"
+
+// Outcome of an inverse kinematics solve
+enum class IkResult {
+    Ok,
+    OutOfReach,   // target outside the annulus |L1 - L2| <= d <= L1 + L2
+    InvalidTarget, // law of cosines gave |cos(angle2)| > 1
+    OutsideLimits  // neither configuration fits the joint limits
+};
+
+// One joint-space solution of the two-link arm
+template <KinematicsScalar T>
+struct BasicArmSolution {
+    T angle1;
+    T angle2;
+};
+
+using ArmSolution = BasicArmSolution<float>;
+
+// Joint limits (radians) and relative joint speeds used to choose between configurations
+struct JointLimits {
+    float min1 = -std::numeric_limits<float>::infinity(), max1 = std::numeric_limits<float>::infinity();
+    float min2 = -std::numeric_limits<float>::infinity(), max2 = std::numeric_limits<float>::infinity();
+    float speed1 = 1, speed2 = 1; // A joint with speed 0.5 takes twice as long for the same angle
+};
+
+// The functions templated on T are defined in Kinematics.cpp and explicitly
+// instantiated there for float and double, and, where marked
+// KinematicsScalar, for FloatLanes; other types do not link.
+
+// Function for linear interpolation between two values
+template <KinematicsScalar T>
+T lerp(T a, T b, T t);
+
+// Function to compute the elbow (x2, y2) and end effector (x3, y3) from the joint angles
+template <KinematicsScalar T>
+void forwardKinematics(T px, T py, T L1, T L2, T angle1, T angle2, T& x2, T& y2, T& x3, T& y3);
+
+// Function to solve both configurations for a target at (dx, dy) from the pivot, without branches;
+// returns the reachable targets, unreachable ones are solved at the nearest reachable distance
+template <KinematicsScalar T>
+typename ScalarOps<T>::Mask solveArmKernel(T dx, T dy, T L1, T L2, BasicArmSolution<T>& up, BasicArmSolution<T>& down);
+
+// Function to calculate both the elbow-up and elbow-down solutions for a target
+template <KinematicsReal T>
+IkResult solveArmConfigurations(T px, T py, T tx, T ty, T L1, T L2, BasicArmSolution<T>& up, BasicArmSolution<T>& down);
+
+// Same as solveArmConfigurations, using the approximate kernels in FastMath.h
+IkResult solveArmConfigurationsFast(float px, float py, float tx, float ty, float L1, float L2, ArmSolution& up, ArmSolution& down);
+
+// Function to map an end-effector velocity to joint velocities (damped least squares)
+template <KinematicsReal T>
+void resolvedRateStep(T L1, T L2, T angle1, T angle2, T vx, T vy, T& dAngle1, T& dAngle2);
+
+// Function to pick the equivalent (2*pi-shifted) angle closest to a reference within [min, max]
+template <KinematicsReal T>
+bool unwrapAngle(T angle, T reference, T min, T max, T& unwrapped);
+
+// Function to choose between two solutions the one with the shortest joint-space move from the current angles
+template <KinematicsReal T>
+IkResult chooseArmConfiguration(const BasicArmSolution<T>& up, const BasicArmSolution<T>& down, const JointLimits& limits,
+                                T& angle1, T& angle2, bool& elbowUp, T& moveTime);
+
+// Function to choose the configuration with the shortest joint-space move from the current angles
+template <KinematicsReal T>
+IkResult selectArmConfiguration(T px, T py, T tx, T ty, T L1, T L2, const JointLimits& limits,
+                                T& angle1, T& angle2, bool& elbowUp, T& moveTime);
+
+// Function to count a solve in the arm_ik_solves_total metric, labelled with its result
+void countIkResult(IkResult result);
+
+// Function to calculate the angles for the robotic arm's joints
+template <KinematicsReal T>
+void calculateArmAngles(T px, T py, T tx, T ty, T L1, T L2, T& angle1, T& angle2, bool& elbowUp);
+
+#endif // KINEMATICS_HPP
@@ -0,0 +1,204 @@
+#include "LinearMove.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include "FrameArena.h"
+
+namespace {
+
+constexpr float kPi = 3.14159265f;
+constexpr int kMaxRefinePasses = 12;
+constexpr float kMinSegment = 1e-3f; // Segments shorter than this (pixels) are not split further
+
+// The move's geometry and the constraints every sample must satisfy
+struct LineContext {
+    float px, py, L1, L2;
+    JointLimits limits;
+    bool elbowUp;
+    float x0, y0;
+    float ux, uy; // Unit direction of the line
+};
+
+void endEffector(const LineContext& line, const ArmSolution& angles, float& x, float& y) {
+    x = line.px + line.L1 * std::cos(angles.angle1) + line.L2 * std::cos(angles.angle1 + angles.angle2);
+    y = line.py + line.L1 * std::sin(angles.angle1) + line.L2 * std::sin(angles.angle1 + angles.angle2);
+}
+
+float deviation(const LineContext& line, const ArmSolution& angles) {
+    float x, y;
+    endEffector(line, angles, x, y);
+    return std::abs((x - line.x0) * line.uy - (y - line.y0) * line.ux);
+}
+
+ArmSolution interpolate(const LinearSample& a, const LinearSample& b, float t) {
+    return {lerp(a.angles.angle1, b.angles.angle1, t), lerp(a.angles.angle2, b.angles.angle2, t)};
+}
+
+// IK for the point at s on the chosen branch, unwrapped towards the reference angles
+IkResult solveSample(const LineContext& line, float s, const ArmSolution& reference, ArmSolution& angles) {
+    float x = line.x0 + line.ux * s;
+    float y = line.y0 + line.uy * s;
+
+    // The start point comes from forward kinematics and can sit a rounding error outside the reach
+    float dx = x - line.px, dy = y - line.py;
+    float distance = std::sqrt(dx * dx + dy * dy);
+    float reach = line.L1 + line.L2;
+    if (distance > reach && distance < reach * (1 + 1e-5f)) {
+        float scale = reach * (1 - 1e-6f) / distance;
+        x = line.px + dx * scale;
+        y = line.py + dy * scale;
+    }
+
+    ArmSolution up, down;
+    IkResult result = solveArmConfigurations(line.px, line.py, x, y, line.L1, line.L2, up, down);
+    if (result != IkResult::Ok) return result;
+
+    const ArmSolution& raw = line.elbowUp ? up : down;
+    const JointLimits& limits = line.limits;
+    if (!unwrapAngle(raw.angle1, reference.angle1, limits.min1, limits.max1, angles.angle1)
+        || !unwrapAngle(raw.angle2, reference.angle2, limits.min2, limits.max2, angles.angle2)) {
+        return IkResult::OutsideLimits;
+    }
+
+    // A jump of more than half a turn means a limit forced the long way round
+    if (std::abs(angles.angle1 - reference.angle1) > kPi || std::abs(angles.angle2 - reference.angle2) > kPi) {
+        return IkResult::OutsideLimits;
+    }
+    return IkResult::Ok;
+}
+
+// Step along the line that keeps roughly constant joint motion per sample
+float sampleStep(const LineContext& line, float s, float maxStep, float minStep) {
+    float x = line.x0 + line.ux * s - line.px;
+    float y = line.y0 + line.uy * s - line.py;
+
+    // |det J| / (L1 L2) = |sin(angle2)|, with cos(angle2) from the law of cosines
+    float cosAngle2 = (x * x + y * y - line.L1 * line.L1 - line.L2 * line.L2) / (2 * line.L1 * line.L2);
+    float conditioning = std::sqrt(std::max(0.0f, 1 - cosAngle2 * cosAngle2));
+    return std::max(minStep, maxStep * conditioning);
+}
+
+} // namespace
+
+/**
+ * Function to plan a straight-line end-effector move.
+ *
+ * The segment is first sampled from its geometry alone: the step shrinks with
+ * |sin(angle2)|, the conditioning of the Jacobian, so samples are dense near the
+ * singular reach boundaries and sparse in the middle of the workspace. IK for
+ * all of those samples is solved in one pass, staying on one elbow branch and
+ * unwrapping each sample towards the previous one. Any segment whose
+ * joint-interpolated midpoint still strays more than the tolerance from the
+ * line is split, and the new samples are again solved together. The largest
+ * remaining deviation is measured at the quarter points of every segment.
+ *
+ * @param px The x-coordinate of the arm's pivot point.
+ * @param py The y-coordinate of the arm's pivot point.
+ * @param L1 The length of the first segment of the arm.
+ * @param L2 The length of the second segment of the arm.
+ * @param limits The joint limits.
+ * @param elbowUp The elbow branch to stay on.
+ * @param angle1 The current angle of the first joint (unwrap reference for the first sample).
+ * @param angle2 The current angle of the second joint (unwrap reference for the first sample).
+ * @param x0 The x-coordinate of the start of the line.
+ * @param y0 The y-coordinate of the start of the line.
+ * @param x1 The x-coordinate of the end of the line.
+ * @param y1 The y-coordinate of the end of the line.
+ * @param tolerance The allowed deviation from the line (pixels).
+ * @param plan The planned move (output, only complete on success).
+ * @return IkResult::Ok if every sample is reachable within the joint limits.
+ */
+IkResult planLinearMove(float px, float py, float L1, float L2, const JointLimits& limits, bool elbowUp,
+                        float angle1, float angle2, float x0, float y0, float x1, float y1, float tolerance,
+                        LinearPlan& plan) {
+    plan.samples.clear();
+    plan.refined = 0;
+    plan.maxDeviation = 0;
+
+    float length = std::sqrt((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+    LineContext line{px, py, L1, L2, limits, elbowUp, x0, y0, 1, 0};
+    if (length > 0) {
+        line.ux = (x1 - x0) / length;
+        line.uy = (y1 - y0) / length;
+    }
+
+    // The line must stay out of the unreachable disc around the pivot; the outer
+    // boundary only needs the end points because distance from the pivot is convex
+    float closest = std::clamp((px - x0) * line.ux + (py - y0) * line.uy, 0.0f, length);
+    float cx = x0 + line.ux * closest - px, cy = y0 + line.uy * closest - py;
+    if (std::sqrt(cx * cx + cy * cy) < std::abs(L1 - L2)) return IkResult::OutOfReach;
+
+    // Geometric sampling, no IK yet
+    float maxStep = 0.05f * (L1 + L2);
+    float minStep = std::max(tolerance, kMinSegment);
+    plan.samples.push_back({0, {}});
+    for (float s = 0; s < length;) {
+        s = std::min(length, s + sampleStep(line, s, maxStep, minStep));
+        plan.samples.push_back({s, {}});
+    }
+
+    // Batch IK, each sample unwrapped towards the one before it
+    ArmSolution reference{angle1, angle2};
+    for (LinearSample& sample : plan.samples) {
+        IkResult result = solveSample(line, sample.s, reference, sample.angles);
+        if (result != IkResult::Ok) return result;
+        reference = sample.angles;
+    }
+
+    // Split segments whose joint-space interpolation bows away from the line; the
+    // scratch lists live in the frame arena and the plan keeps its own storage
+    FrameArena::Scope scratch(frameArena());
+    ArenaVector<LinearSample> inserted;
+    ArenaVector<LinearSample> merged;
+    for (int pass = 0; pass < kMaxRefinePasses; ++pass) {
+        inserted.clear();
+        for (size_t i = 0; i + 1 < plan.samples.size(); ++i) {
+            const LinearSample& a = plan.samples[i];
+            const LinearSample& b = plan.samples[i + 1];
+            if (b.s - a.s < 2 * kMinSegment) continue;
+            if (deviation(line, interpolate(a, b, 0.5f)) > tolerance) {
+                inserted.push_back({0.5f * (a.s + b.s), a.angles}); // angles hold the unwrap reference until solved
+            }
+        }
+        if (inserted.empty()) break;
+
+        for (LinearSample& sample : inserted) {
+            ArmSolution reference = sample.angles;
+            IkResult result = solveSample(line, sample.s, reference, sample.angles);
+            if (result != IkResult::Ok) return result;
+        }
+        plan.refined += inserted.size();
+
+        merged.clear();
+        std::merge(plan.samples.begin(), plan.samples.end(), inserted.begin(), inserted.end(), std::back_inserter(merged),
+                   [](const LinearSample& a, const LinearSample& b) { return a.s < b.s; });
+        plan.samples.assign(merged.begin(), merged.end());
+    }
+
+    for (size_t i = 0; i + 1 < plan.samples.size(); ++i) {
+        for (float t : {0.25f, 0.5f, 0.75f}) {
+            plan.maxDeviation = std::max(plan.maxDeviation, deviation(line, interpolate(plan.samples[i], plan.samples[i + 1], t)));
+        }
+    }
+    return IkResult::Ok;
+}
+
+/**
+ * Function to interpolate the joint angles of a planned move.
+ *
+ * @param plan The planned move (at least one sample).
+ * @param s The distance along the line, clamped to the move.
+ * @return The joint angles at s.
+ */
+ArmSolution sampleLinearMove(const LinearPlan& plan, float s) {
+    const std::vector<LinearSample>& samples = plan.samples;
+    if (s <= samples.front().s) return samples.front().angles;
+    if (s >= samples.back().s) return samples.back().angles;
+
+    auto next = std::upper_bound(samples.begin(), samples.end(), s,
+                                 [](float value, const LinearSample& sample) { return value < sample.s; });
+    const LinearSample& b = *next;
+    const LinearSample& a = *(next - 1);
+    return interpolate(a, b, (s - a.s) / (b.s - a.s));
+}
@@ -0,0 +1,29 @@
+#ifndef LINEARMOVE_HPP
+#define LINEARMOVE_HPP
+
+#include <cstddef>
+#include <vector>
+#include "Kinematics.h"
+
+// One IK sample of a Cartesian straight-line move
+struct LinearSample {
+    float s;            // Distance along the line from the start (pixels)
+    ArmSolution angles; // Joint angles that put the end effector on the line at s
+};
+
+// A planned straight-line move; joint angles between samples are interpolated linearly in s
+struct LinearPlan {
+    std::vector<LinearSample> samples;
+    size_t refined = 0;     // Samples added because the first sampling deviated too far
+    float maxDeviation = 0; // Largest distance of the interpolated claw path from the line (pixels)
+};
+
+// Function to plan a straight-line end-effector move as one batch of IK samples
+IkResult planLinearMove(float px, float py, float L1, float L2, const JointLimits& limits, bool elbowUp,
+                        float angle1, float angle2, float x0, float y0, float x1, float y1, float tolerance,
+                        LinearPlan& plan);
+
+// Function to interpolate the joint angles of a planned move at distance s along the line
+ArmSolution sampleLinearMove(const LinearPlan& plan, float s);
+
+#endif // LINEARMOVE_HPP
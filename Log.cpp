@@ -0,0 +1,260 @@
+#include "Log.h"
+#include "Metrics.h"
+#include "MpscQueue.h"
+
+#include <cstdio>
+
+namespace {
+
+// One line of a message as it travels through the queue
+struct LogRecord {
+    LogLevel level;
+    uint32_t suppressed; // Similar messages dropped by the rate limit before this one
+    uint32_t length;
+    char text[kLogLineSize];
+};
+
+// Rate-limit state of the messages whose key falls into one slot
+struct alignas(64) LimitSlot {
+    std::atomic<int64_t> second{-1};
+    std::atomic<uint32_t> sent{0};
+    std::atomic<uint32_t> suppressed{0};
+};
+
+constexpr size_t kLimitSlots = 256;
+constexpr size_t kLogQueueSize = 1024;
+
+std::atomic<int> minimumLevel{static_cast<int>(LogLevel::Info)};
+LimitSlot limits[kLimitSlots];
+std::atomic<uint64_t> dropped{0};
+std::mutex syncMutex;
+
+// Function to get the queue between the logging threads and the writer
+MpscQueue<LogRecord>& logQueue() {
+    static MpscQueue<LogRecord> queue(kLogQueueSize);
+    return queue;
+}
+
+// Function to format a line for output, with its level and suppression note
+void formatLine(std::string& out, LogLevel level, std::string_view text, uint32_t suppressed) {
+    switch (level) {
+        case LogLevel::Debug: out += "Debug: "; break;
+        case LogLevel::Info: break;
+        case LogLevel::Warning: out += "Warning: "; break;
+        case LogLevel::Error: out += "Error: "; break;
+    }
+    out += text;
+    if (suppressed > 0) {
+        out += " (";
+        out += std::to_string(suppressed);
+        out += " similar messages suppressed)";
+    }
+}
+
+// Function to call f for each line of a message, without the trailing newlines
+template <typename F>
+void forEachLine(const LogBuffer& message, F f) {
+    std::string_view text(message.text, message.length);
+    while (!text.empty() && text.back() == '\n') text.remove_suffix(1);
+    for (;;) {
+        size_t end = text.find('\n');
+        f(text.substr(0, end), end == std::string_view::npos);
+        if (end == std::string_view::npos) break;
+        text.remove_prefix(end + 1);
+    }
+}
+
+} // namespace
+
+void setLogLevel(LogLevel level) {
+    minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel logLevel() {
+    return static_cast<LogLevel>(minimumLevel.load(std::memory_order_relaxed));
+}
+
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    if (name == "debug") level = LogLevel::Debug;
+    else if (name == "info") level = LogLevel::Info;
+    else if (name == "warning") level = LogLevel::Warning;
+    else if (name == "error") level = LogLevel::Error;
+    else return false;
+    return true;
+}
+
+LogBuffer& logBuffer() {
+    thread_local LogBuffer buffer;
+    return buffer;
+}
+
+/**
+ * Function to decide whether a message is logged.
+ *
+ * Messages below the log level are dropped. The others share a budget of
+ * kLogBurst messages per second with every message of the same key (messages
+ * whose keys collide in the slot table share it too). The first message of a
+ * new second collects the count suppressed since the last one that got
+ * through.
+ *
+ * @param level The level of the message.
+ * @param key The rate-limit key of the message, 0 for no limit.
+ * @param suppressed The number of suppressed messages to report with this one (output).
+ * @return True if the message should be formatted and submitted.
+ */
+bool admitLog(LogLevel level, uint64_t key, uint32_t& suppressed) {
+    suppressed = 0;
+    if (static_cast<int>(level) < minimumLevel.load(std::memory_order_relaxed)) return false;
+    if (key == 0) return true;
+
+    static Counter& limited = metrics().counter("arm_log_messages_suppressed_total",
+                                                "Log messages dropped by the per-message rate limit.");
+    LimitSlot& slot = limits[(key >> 32) % kLimitSlots];
+    int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t second = slot.second.load(std::memory_order_relaxed);
+    if (second != now && slot.second.compare_exchange_strong(second, now, std::memory_order_relaxed)) {
+        slot.sent.store(0, std::memory_order_relaxed);
+        suppressed = slot.suppressed.exchange(0, std::memory_order_relaxed);
+    }
+    if (slot.sent.load(std::memory_order_relaxed) < kLogBurst && slot.sent.fetch_add(1, std::memory_order_relaxed) < kLogBurst) {
+        return true;
+    }
+
+    slot.suppressed.fetch_add(suppressed + 1, std::memory_order_relaxed); // Hand a collected count back
+    suppressed = 0;
+    limited.add();
+    return false;
+}
+
+/**
+ * Function to hand a formatted message to the writer, one queue record per line.
+ *
+ * Without a running writer the message is written to stdout right away.
+ *
+ * @param level The level of the message.
+ * @param message The formatted message; lines beyond kLogLineSize characters are cut off.
+ * @param suppressed The number of suppressed messages to report with it.
+ * @return none
+ */
+void submitLog(LogLevel level, const LogBuffer& message, uint32_t suppressed) {
+    if (!logWriter().isRunning()) {
+        std::string out;
+        forEachLine(message, [&](std::string_view line, bool last) {
+            formatLine(out, level, line, last ? suppressed : 0);
+            out += '\n';
+        });
+        std::lock_guard<std::mutex> lock(syncMutex);
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        std::fflush(stdout);
+        return;
+    }
+
+    static Counter& lost = metrics().counter("arm_log_messages_dropped_total",
+                                             "Log lines dropped because the log queue was full.");
+    LogRecord record;
+    record.level = level;
+    forEachLine(message, [&](std::string_view line, bool last) {
+        record.suppressed = last ? suppressed : 0;
+        record.length = static_cast<uint32_t>(line.copy(record.text, kLogLineSize));
+        if (!logQueue().push(record)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            lost.add();
+        }
+    });
+}
+
+LogWriter::LogWriter() {
+    // Build the queue and the registry first, so they are destroyed after the writer's final drain
+    logQueue();
+    metrics();
+}
+
+LogWriter::~LogWriter() {
+    stop();
+}
+
+void LogWriter::start() {
+    if (worker.joinable()) return;
+    stopping = false;
+    worker = std::thread(&LogWriter::run, this);
+    running.store(true, std::memory_order_release);
+}
+
+void LogWriter::stop() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+    running.store(false, std::memory_order_release);
+    drain(); // Lines queued while the writer was finishing
+    flushRepeats();
+}
+
+void LogWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, std::chrono::milliseconds(10), [this] { return stopping; })) {
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+    lock.unlock();
+    drain();
+}
+
+/**
+ * Function to write every queued line with one flush.
+ *
+ * A line equal to the one before it is counted instead of written; the count
+ * is written when a different line arrives or a second after the first
+ * repeat.
+ *
+ * @return none
+ */
+void LogWriter::drain() {
+    std::string out;
+    std::string line;
+    LogRecord record;
+    auto now = std::chrono::steady_clock::now();
+
+    while (logQueue().pop(record)) {
+        line.clear();
+        formatLine(line, record.level, std::string_view(record.text, record.length), record.suppressed);
+        if (line == lastLine) {
+            if (repeats++ == 0) firstRepeat = now;
+            continue;
+        }
+        if (repeats > 0) {
+            out += "(last message repeated " + std::to_string(repeats) + " times)\n";
+            repeats = 0;
+        }
+        out += line;
+        out += '\n';
+        lastLine = line;
+    }
+    if (repeats > 0 && now - firstRepeat >= std::chrono::seconds(1)) {
+        out += "(last message repeated " + std::to_string(repeats) + " times)\n";
+        repeats = 0;
+    }
+    if (uint64_t lost = dropped.exchange(0, std::memory_order_relaxed)) {
+        out += "(" + std::to_string(lost) + " log lines dropped, queue full)\n";
+    }
+
+    if (out.empty()) return;
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    std::fflush(stdout);
+}
+
+void LogWriter::flushRepeats() {
+    if (repeats == 0) return;
+    std::printf("(last message repeated %llu times)\n", static_cast<unsigned long long>(repeats));
+    std::fflush(stdout);
+    repeats = 0;
+}
+
+LogWriter& logWriter() {
+    static LogWriter writer;
+    return writer;
+}
@@ -0,0 +1,179 @@
+#ifndef LOG_HPP
+#define LOG_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+/*
+ * Diagnostics of the simulator. A message is formatted on the calling thread
+ * into a thread-local buffer (no heap, no I/O), pushed onto a lock-free queue
+ * and written to stdout by the LogWriter thread, so a frame or control tick
+ * never waits for the terminal:
+ *
+ *     logWarning("Target is out of reach!");
+ *     logInfo("Control loop at ", rateHz, " Hz");
+ *
+ * Arguments are printed like std::cout prints them (floating point with six
+ * significant digits). Messages below the level set with setLogLevel are
+ * dropped before formatting.
+ *
+ * Each message is rate limited by its first argument: at most kLogBurst
+ * messages per second start with the same text, so a drag that re-targets the
+ * arm every tick logs a few lines instead of one per tick; the next message
+ * that gets through says how many were suppressed. The writer also folds
+ * repeats of an identical line into one "repeated N times" note.
+ *
+ * Until the writer is started (and after it stops) messages are written
+ * synchronously, still rate limited, so tools that never start it lose
+ * nothing.
+ */
+
+enum class LogLevel { Debug, Info, Warning, Error };
+
+constexpr size_t kLogMessageSize = 4096; // Longest message; more is cut off
+constexpr size_t kLogLineSize = 240;     // Longest line of a message in the queue; more is cut off
+constexpr uint32_t kLogBurst = 5;        // Messages per second starting with the same text
+
+// Function to set the lowest level that is logged (Info by default)
+void setLogLevel(LogLevel level);
+LogLevel logLevel();
+
+// Function to parse "debug", "info", "warning" or "error"; false for anything else
+bool parseLogLevel(const std::string& name, LogLevel& level);
+
+// Message being formatted on the calling thread
+struct LogBuffer {
+    char text[kLogMessageSize];
+    size_t length = 0;
+
+    void append(std::string_view value) {
+        size_t n = std::min(value.size(), kLogMessageSize - length);
+        value.copy(text + length, n);
+        length += n;
+    }
+    void append(const char* value) { append(std::string_view(value)); }
+    void append(const std::string& value) { append(std::string_view(value)); }
+    void append(char value) { append(std::string_view(&value, 1)); }
+    void append(bool value) { append(value ? '1' : '0'); }
+
+    template <std::integral T>
+    void append(T value) {
+        length = std::to_chars(text + length, text + kLogMessageSize, value).ptr - text;
+    }
+
+    template <std::floating_point T>
+    void append(T value) {
+        auto result = std::to_chars(text + length, text + kLogMessageSize, value, std::chars_format::general, 6);
+        if (result.ec == std::errc()) length = result.ptr - text;
+    }
+};
+
+// Function to get the rate-limit key of a message from its first argument
+inline uint64_t logKey(std::string_view text) {
+    uint64_t hash = 1469598103934665603ull; // FNV-1a
+    for (char c : text) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    return hash;
+}
+
+inline uint64_t logKey(const char* text) { return logKey(std::string_view(text)); }
+inline uint64_t logKey(const std::string& text) { return logKey(std::string_view(text)); }
+
+template <typename T>
+uint64_t logKey(const T&) {
+    return 0;
+}
+
+// Function to check the level and rate limit of a message; suppressed is the count to report with it
+bool admitLog(LogLevel level, uint64_t key, uint32_t& suppressed);
+
+// Function to queue (or write) a formatted message
+void submitLog(LogLevel level, const LogBuffer& message, uint32_t suppressed);
+
+// Function to get the calling thread's format buffer
+LogBuffer& logBuffer();
+
+// Function to log a message made of the arguments, printed one after another
+template <typename First, typename... Rest>
+void logMessage(LogLevel level, const First& first, const Rest&... rest) {
+    uint32_t suppressed;
+    if (!admitLog(level, logKey(first), suppressed)) return;
+    LogBuffer& message = logBuffer();
+    message.length = 0;
+    message.append(first);
+    (message.append(rest), ...);
+    submitLog(level, message, suppressed);
+}
+
+template <typename... Args>
+void logDebug(const Args&... args) { logMessage(LogLevel::Debug, args...); }
+
+template <typename... Args>
+void logInfo(const Args&... args) { logMessage(LogLevel::Info, args...); }
+
+template <typename... Args>
+void logWarning(const Args&... args) { logMessage(LogLevel::Warning, args...); }
+
+template <typename... Args>
+void logError(const Args&... args) { logMessage(LogLevel::Error, args...); }
+
+/**
+ * Background thread that drains the log queue to stdout. It wakes every few
+ * milliseconds, writes everything queued with one flush, and on stop writes
+ * what is left. Lines dropped because the queue was full are counted and
+ * reported.
+ */
+class LogWriter {
+public:
+    // Runs the writer while the scope is open, so every return path writes what is queued
+    class Scope {
+    public:
+        explicit Scope(LogWriter& writer) : writer(writer) { writer.start(); }
+        ~Scope() { writer.stop(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        LogWriter& writer;
+    };
+
+    LogWriter();
+    ~LogWriter();
+
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+
+    void start();
+    void stop(); // Writes what is queued; later messages are written synchronously
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+private:
+    void run();
+    void drain();
+    void flushRepeats();
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    // Writer-thread state for folding identical lines
+    std::string lastLine;
+    uint64_t repeats = 0;
+    std::chrono::steady_clock::time_point firstRepeat;
+};
+
+// Function to get the process-wide writer
+LogWriter& logWriter();
+
+#endif // LOG_HPP
@@ -0,0 +1,251 @@
+#include "Metrics.h"
+#include "AllocCounter.h"
+#include "Log.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+// The labels of a metric name, without the braces ("" without labels)
+std::string labelsOf(const std::string& name) {
+    size_t open = name.find('{');
+    if (open == std::string::npos) return "";
+    return name.substr(open + 1, name.size() - open - 2);
+}
+
+// A sample value in the fewest digits that round-trip (0.004, not 0.0040000000000000001)
+std::string formatValue(double value) {
+    char text[32];
+    for (int digits = 15; digits <= 17; ++digits) {
+        std::snprintf(text, sizeof(text), "%.*g", digits, value);
+        if (std::strtod(text, nullptr) == value) break;
+    }
+    return text;
+}
+
+// Resident set size of this process in bytes, 0 if unknown
+double residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE));
+}
+
+} // namespace
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const Cell& cell : cells) total += cell.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+Histogram::Histogram(std::vector<double> bounds) : bounds(std::move(bounds)) {
+    for (Shard& shard : shards) {
+        shard.buckets = std::make_unique<std::atomic<uint64_t>[]>(this->bounds.size() + 1);
+    }
+}
+
+/**
+ * Function to add an observation to the calling thread's shard.
+ *
+ * @param value The observed value.
+ * @return none
+ */
+void Histogram::observe(double value) {
+    size_t bucket = 0;
+    while (bucket < bounds.size() && value > bounds[bucket]) ++bucket;
+    Shard& shard = shards[metricShard()];
+    shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * Function to sum the shards of the histogram.
+ *
+ * Shards are read one after another while other threads keep observing, so
+ * the counts may be a few observations apart from the sum; each value is
+ * still monotonic between reads, as Prometheus expects.
+ *
+ * @param counts The count of each bucket, the last one for values above every bound (output).
+ * @param count The number of observations (output).
+ * @param sum The sum of the observations (output).
+ * @return none
+ */
+void Histogram::read(std::vector<uint64_t>& counts, uint64_t& count, double& sum) const {
+    counts.assign(bounds.size() + 1, 0);
+    count = 0;
+    sum = 0;
+    for (const Shard& shard : shards) {
+        for (size_t i = 0; i <= bounds.size(); ++i) {
+            uint64_t n = shard.buckets[i].load(std::memory_order_relaxed);
+            counts[i] += n;
+            count += n;
+        }
+        sum += shard.sum.load(std::memory_order_relaxed);
+    }
+}
+
+std::vector<double> exponentialBuckets(double start, double factor, int count) {
+    std::vector<double> bounds;
+    for (int i = 0; i < count; ++i, start *= factor) bounds.push_back(start);
+    return bounds;
+}
+
+MetricsRegistry::Entry* MetricsRegistry::find(const std::string& name) {
+    for (const std::unique_ptr<Entry>& entry : entries) {
+        if (entry->name == name) return entry.get();
+    }
+    return nullptr;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (Entry* entry = find(name); entry && entry->counter) return *entry->counter;
+    entries.push_back(std::make_unique<Entry>(Entry{name, name.substr(0, name.find('{')), help, Type::Counter,
+                                                    std::make_unique<Counter>(), nullptr, nullptr}));
+    return *entries.back()->counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (Entry* entry = find(name); entry && entry->gauge) return *entry->gauge;
+    entries.push_back(std::make_unique<Entry>(Entry{name, name.substr(0, name.find('{')), help, Type::Gauge,
+                                                    nullptr, std::make_unique<Gauge>(), nullptr}));
+    return *entries.back()->gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::vector<double>& bounds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (Entry* entry = find(name); entry && entry->histogram) return *entry->histogram;
+    entries.push_back(std::make_unique<Entry>(Entry{name, name.substr(0, name.find('{')), help, Type::Histogram,
+                                                    nullptr, nullptr, std::make_unique<Histogram>(bounds)}));
+    return *entries.back()->histogram;
+}
+
+/**
+ * Function to format every metric in the Prometheus text exposition format.
+ *
+ * Families are written in the order they were first registered, each with one
+ * HELP and TYPE line; histograms expand into cumulative _bucket series plus
+ * _sum and _count.
+ *
+ * @return The text, one sample per line.
+ */
+std::string MetricsRegistry::exportText() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    std::vector<bool> written(entries.size(), false);
+    std::vector<uint64_t> counts;
+
+    for (size_t first = 0; first < entries.size(); ++first) {
+        if (written[first]) continue;
+        const Entry& head = *entries[first];
+        const char* type = head.type == Type::Counter ? "counter" : head.type == Type::Gauge ? "gauge" : "histogram";
+        out << "# HELP " << head.family << " " << head.help << "\n";
+        out << "# TYPE " << head.family << " " << type << "\n";
+
+        for (size_t i = first; i < entries.size(); ++i) {
+            const Entry& entry = *entries[i];
+            if (written[i] || entry.family != head.family) continue;
+            written[i] = true;
+
+            if (entry.counter) {
+                out << entry.name << " " << entry.counter->value() << "\n";
+            } else if (entry.gauge) {
+                out << entry.name << " " << formatValue(entry.gauge->value()) << "\n";
+            } else {
+                uint64_t count;
+                double sum;
+                entry.histogram->read(counts, count, sum);
+                std::string labels = labelsOf(entry.name);
+                std::string prefix = labels.empty() ? "" : labels + ",";
+                std::string suffix = labels.empty() ? "" : "{" + labels + "}";
+                const std::vector<double>& bounds = entry.histogram->upperBounds();
+                uint64_t cumulative = 0;
+                for (size_t b = 0; b < bounds.size(); ++b) {
+                    cumulative += counts[b];
+                    out << entry.family << "_bucket{" << prefix << "le=\"" << formatValue(bounds[b]) << "\"} " << cumulative << "\n";
+                }
+                out << entry.family << "_bucket{" << prefix << "le=\"+Inf\"} " << count << "\n";
+                out << entry.family << "_sum" << suffix << " " << formatValue(sum) << "\n";
+                out << entry.family << "_count" << suffix << " " << count << "\n";
+            }
+        }
+    }
+    return out.str();
+}
+
+MetricsRegistry& metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+/**
+ * Function to start writing the metrics file periodically.
+ *
+ * @param path The file to write, e.g. in node_exporter's --collector.textfile.directory with a .prom extension.
+ * @param intervalSeconds The time between dumps.
+ * @return True if the first dump was written and the thread started.
+ */
+bool MetricsExporter::start(const std::string& path, double intervalSeconds) {
+    this->path = path;
+    this->intervalSeconds = intervalSeconds > 0 ? intervalSeconds : 15;
+    stopping = false;
+    if (!write()) {
+        logError("Failed to write metrics to ", path);
+        return false;
+    }
+    worker = std::thread(&MetricsExporter::run, this);
+    logInfo("Writing metrics to ", path, " every ", this->intervalSeconds, " s");
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+    write();
+}
+
+void MetricsExporter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto interval = std::chrono::duration<double>(intervalSeconds);
+    while (!wake.wait_for(lock, interval, [this] { return stopping; })) {
+        lock.unlock();
+        write();
+        lock.lock();
+    }
+}
+
+/**
+ * Function to write one dump of the registry.
+ *
+ * @return True if the file was replaced.
+ */
+bool MetricsExporter::write() {
+    static Gauge& resident = metrics().gauge("arm_resident_memory_bytes", "Resident memory of the simulator in bytes.");
+    static Gauge& allocations = metrics().gauge("arm_heap_allocations", "Heap allocations since start (debug builds only).");
+    resident.set(residentBytes());
+    allocations.set(static_cast<double>(heapAllocationCount()));
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << metrics().exportText();
+        if (!file) return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,151 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Operational metrics of a running simulation: counters, gauges and
+ * histograms in one process-wide registry (metrics()), written out in the
+ * Prometheus text format by MetricsExporter for node_exporter's textfile
+ * collector.
+ *
+ * Updates are a relaxed atomic add on a cache line owned by the calling
+ * thread's shard, so threads never contend on a hot counter; reading sums the
+ * shards. Registration takes a lock and is meant for startup or a
+ * function-local static reference, not for hot paths:
+ *
+ *     static Counter& solves = metrics().counter("arm_ik_solves_total", "IK solves");
+ *     solves.add();
+ *
+ * A name may carry labels (name{key="value"}); metrics with the same name
+ * before the braces form one family and share its help text and type.
+ */
+
+constexpr size_t kMetricShards = 16;
+
+// Function to get the calling thread's shard, assigned round robin on first use
+inline size_t metricShard() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t shard = next.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+// Monotonic count
+class Counter {
+public:
+    void add(uint64_t n = 1) { cells[metricShard()].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value{0};
+    };
+    Cell cells[kMetricShards];
+};
+
+// Value that goes up and down; the last write wins
+class Gauge {
+public:
+    void set(double value) { current.store(value, std::memory_order_relaxed); }
+    void add(double delta) { current.fetch_add(delta, std::memory_order_relaxed); }
+    double value() const { return current.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> current{0};
+};
+
+// Distribution over fixed upper bounds, with the sum and count of all observations
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double value);
+
+    // Counts per bucket (not cumulative, the last one above every bound), their sum and the sum of the values
+    void read(std::vector<uint64_t>& counts, uint64_t& count, double& sum) const;
+    const std::vector<double>& upperBounds() const { return bounds; }
+
+private:
+    struct alignas(64) Shard {
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+        std::atomic<double> sum{0};
+    };
+    std::vector<double> bounds;
+    Shard shards[kMetricShards];
+};
+
+// Function to get bucket bounds start, start * factor, ... (count bounds)
+std::vector<double> exponentialBuckets(double start, double factor, int count);
+
+class MetricsRegistry {
+public:
+    // Each returns the metric registered under `name`, creating it on first use
+    Counter& counter(const std::string& name, const std::string& help);
+    Gauge& gauge(const std::string& name, const std::string& help);
+    Histogram& histogram(const std::string& name, const std::string& help, const std::vector<double>& bounds);
+
+    // All metrics in the Prometheus text exposition format
+    std::string exportText() const;
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Entry {
+        std::string name;
+        std::string family;
+        std::string help;
+        Type type;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    Entry* find(const std::string& name);
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Entry>> entries;
+};
+
+// Function to get the process-wide registry
+MetricsRegistry& metrics();
+
+/**
+ * Background thread that rewrites a Prometheus text file with the registry's
+ * contents every interval. Each dump goes to a temporary file that is renamed
+ * over the target, so a collector never reads a half-written file. Process
+ * memory (resident set) and heap allocation gauges are sampled just before
+ * each dump.
+ */
+class MetricsExporter {
+public:
+    MetricsExporter() = default;
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    bool start(const std::string& path, double intervalSeconds);
+    void stop(); // Writes a final dump
+    bool isRunning() const { return worker.joinable(); }
+
+private:
+    void run();
+    bool write();
+
+    std::string path;
+    double intervalSeconds = 15;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+#endif // METRICS_HPP
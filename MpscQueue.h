@@ -0,0 +1,77 @@
+#ifndef MPSCQUEUE_HPP
+#define MPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Bounded lock-free multi-producer/single-consumer ring buffer.
+ *
+ * Any number of threads may call push() and one thread may call pop(). Each
+ * slot carries a sequence number that tells producers whether it is free and
+ * the consumer whether it has been written, so a producer claims a slot with
+ * one compare-exchange on the tail and never waits for another producer to
+ * finish its copy. The capacity is rounded up to a power of two; head and
+ * tail live on separate cache lines.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells = std::make_unique<Cell[]>(size);
+        for (std::size_t i = 0; i < size; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+        mask = size - 1;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Producer side, any thread. Returns false (and drops nothing) if the queue is full.
+    bool push(const T& value) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[t & mask];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto lag = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(t);
+            if (lag == 0) {
+                if (tail.compare_exchange_weak(t, t + 1, std::memory_order_relaxed)) break;
+            } else if (lag < 0) {
+                return false; // The slot still holds an item from the previous lap
+            } else {
+                t = tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty (or the oldest item is still being written).
+    bool pop(T& value) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        Cell& cell = cells[h & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != h + 1) return false;
+        value = cell.value;
+        cell.sequence.store(h + mask + 1, std::memory_order_release);
+        head.store(h + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask = 0;
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+};
+
+#endif // MPSCQUEUE_HPP
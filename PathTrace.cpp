@@ -0,0 +1,364 @@
+#include "PathTrace.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "Log.h"
+#include "Simulation.h"
+#include "TaskPool.h"
+
+namespace {
+
+constexpr float kTwoPi = 6.28318531f;
+constexpr int kCurveSegments = 16;       // Line segments per SVG Bezier curve
+constexpr size_t kMinChunk = 1024;       // Fewer samples per thread are not worth a thread
+constexpr float kTraceTolerance = 0.5f;  // Tracking error that triggers a warning (pixels)
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool loadPolyline(std::istream& in, std::vector<PathPoint>& points) {
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        PathPoint point;
+        if (line.empty() || line[0] == '#') continue;
+        if (!(fields >> point.x >> point.y)) return false;
+        points.push_back(point);
+    }
+    return true;
+}
+
+// The d attribute of the first <path> element, without a full XML parser
+bool findSvgPathData(const std::string& svg, std::string& data) {
+    size_t element = svg.find("<path");
+    if (element == std::string::npos) return false;
+    size_t attribute = svg.find(" d=", element);
+    if (attribute == std::string::npos || attribute + 4 > svg.size()) return false;
+
+    char quote = svg[attribute + 3];
+    size_t end = svg.find(quote, attribute + 4);
+    if (end == std::string::npos) return false;
+    data = svg.substr(attribute + 4, end - attribute - 4);
+    return true;
+}
+
+/**
+ * Parses the M, L, H, V, C, Q and Z commands of an SVG path (absolute and
+ * relative). Curves are flattened into kCurveSegments line segments.
+ */
+bool parseSvgPath(const std::string& data, std::vector<PathPoint>& points) {
+    const char* cursor = data.c_str();
+    char command = 0;
+    float x = 0, y = 0, startX = 0, startY = 0;
+
+    auto number = [&cursor](float& value) {
+        while (*cursor == ' ' || *cursor == ',' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r') ++cursor;
+        char* end;
+        value = std::strtof(cursor, &end);
+        if (end == cursor) return false;
+        cursor = end;
+        return true;
+    };
+
+    while (true) {
+        while (*cursor == ' ' || *cursor == ',' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r') ++cursor;
+        if (*cursor == 0) break;
+        if (std::isalpha(static_cast<unsigned char>(*cursor))) {
+            command = *cursor++;
+        } else if (command == 0) {
+            return false; // Numbers before the first command
+        }
+
+        bool relative = std::islower(static_cast<unsigned char>(command));
+        float ox = relative ? x : 0, oy = relative ? y : 0;
+        switch (std::toupper(static_cast<unsigned char>(command))) {
+            case 'M':
+            case 'L': {
+                float nx, ny;
+                if (!number(nx) || !number(ny)) return false;
+                x = ox + nx;
+                y = oy + ny;
+                if (std::toupper(static_cast<unsigned char>(command)) == 'M') {
+                    startX = x;
+                    startY = y;
+                    command = relative ? 'l' : 'L'; // Further pairs after a moveto are linetos
+                }
+                points.push_back({x, y});
+                break;
+            }
+            case 'H': {
+                float nx;
+                if (!number(nx)) return false;
+                x = ox + nx;
+                points.push_back({x, y});
+                break;
+            }
+            case 'V': {
+                float ny;
+                if (!number(ny)) return false;
+                y = oy + ny;
+                points.push_back({x, y});
+                break;
+            }
+            case 'C':
+            case 'Q': {
+                bool cubic = std::toupper(static_cast<unsigned char>(command)) == 'C';
+                float c[6];
+                int count = cubic ? 6 : 4;
+                for (int i = 0; i < count; ++i) {
+                    if (!number(c[i])) return false;
+                    c[i] += i % 2 == 0 ? ox : oy;
+                }
+                float x0 = x, y0 = y;
+                for (int i = 1; i <= kCurveSegments; ++i) {
+                    float t = static_cast<float>(i) / kCurveSegments, u = 1 - t;
+                    if (cubic) {
+                        x = u * u * u * x0 + 3 * u * u * t * c[0] + 3 * u * t * t * c[2] + t * t * t * c[4];
+                        y = u * u * u * y0 + 3 * u * u * t * c[1] + 3 * u * t * t * c[3] + t * t * t * c[5];
+                    } else {
+                        x = u * u * x0 + 2 * u * t * c[0] + t * t * c[2];
+                        y = u * u * y0 + 2 * u * t * c[1] + t * t * c[3];
+                    }
+                    points.push_back({x, y});
+                }
+                break;
+            }
+            case 'Z':
+                x = startX;
+                y = startY;
+                points.push_back({x, y});
+                command = 0;
+                break;
+            default:
+                logWarning("Unsupported SVG path command '", command, "'");
+                return false;
+        }
+    }
+    return true;
+}
+
+// Solve one chunk on the arm's branch, unwrapping sample by sample from the chunk's first raw solution
+void solveChunk(const std::vector<PathPoint>& points, const ArmState& arm, bool elbowUp, size_t begin, size_t end,
+                std::vector<ArmSolution>& angles, size_t& unreachable) {
+    for (size_t i = begin; i < end; ++i) {
+        ArmSolution up, down;
+        if (solveArmConfigurations(arm.px, arm.py, points[i].x, points[i].y, arm.L1, arm.L2, up, down) != IkResult::Ok) {
+            ++unreachable;
+            angles[i] = i > begin ? angles[i - 1] : ArmSolution{arm.currentAngle1, arm.currentAngle2};
+            continue;
+        }
+        ArmSolution raw = elbowUp ? up : down;
+        if (i > begin) {
+            const ArmSolution& previous = angles[i - 1];
+            raw.angle1 += std::round((previous.angle1 - raw.angle1) / kTwoPi) * kTwoPi;
+            raw.angle2 += std::round((previous.angle2 - raw.angle2) / kTwoPi) * kTwoPi;
+        }
+        angles[i] = raw;
+    }
+}
+
+PathPoint forward(const ArmState& arm, const ArmSolution& angles) {
+    return {arm.px + arm.L1 * std::cos(angles.angle1) + arm.L2 * std::cos(angles.angle1 + angles.angle2),
+            arm.py + arm.L1 * std::sin(angles.angle1) + arm.L2 * std::sin(angles.angle1 + angles.angle2)};
+}
+
+float distance(const PathPoint& a, const PathPoint& b) {
+    return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+}
+
+} // namespace
+
+/**
+ * Function to load a path to trace.
+ *
+ * Files ending in .svg are searched for the first <path d="..."> element;
+ * anything else is read as a polyline with one "x y" point per line (lines
+ * starting with # are comments). Coordinates are in the file's own units;
+ * mapPathToWorkspace fits them to the arm.
+ *
+ * @param filename The path file.
+ * @param points The loaded points (output).
+ * @return True if the file was read and has at least one point.
+ */
+bool loadPath(const std::string& filename, std::vector<PathPoint>& points) {
+    points.clear();
+    std::ifstream in(filename);
+    if (!in) {
+        logError("Failed to open path ", filename);
+        return false;
+    }
+
+    bool ok;
+    if (endsWith(filename, ".svg")) {
+        std::stringstream contents;
+        contents << in.rdbuf();
+        std::string data;
+        ok = findSvgPathData(contents.str(), data) && parseSvgPath(data, points);
+    } else {
+        ok = loadPolyline(in, points);
+    }
+
+    if (!ok || points.empty()) {
+        logError("Path ", filename, " has no usable points");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Function to scale and move a path into the arm's workspace.
+ *
+ * The path keeps its aspect ratio and is centred on the largest axis-aligned
+ * square to the right of the pivot, at distance max(L1, L2), that fits inside
+ * the reachable annulus. Every mapped point is therefore reachable without
+ * passing the singular boundaries.
+ *
+ * @param points The path to map (input/output).
+ * @param arm The arm that will trace it.
+ * @return none
+ */
+void mapPathToWorkspace(std::vector<PathPoint>& points, const ArmState& arm) {
+    float minX = points[0].x, maxX = points[0].x, minY = points[0].y, maxY = points[0].y;
+    for (const PathPoint& point : points) {
+        minX = std::min(minX, point.x);
+        maxX = std::max(maxX, point.x);
+        minY = std::min(minY, point.y);
+        maxY = std::max(maxY, point.y);
+    }
+
+    // Square centred at distance r from the pivot: the far corners bound it by
+    // (r + h)^2 + h^2 <= (L1 + L2)^2, the near edge by r - h >= |L1 - L2|
+    float outer = arm.L1 + arm.L2, inner = std::abs(arm.L1 - arm.L2);
+    float r = std::max(arm.L1, arm.L2);
+    float half = std::min((-r + std::sqrt(2 * outer * outer - r * r)) / 2, r - inner) * 0.95f;
+
+    float extent = std::max(maxX - minX, maxY - minY);
+    float scale = extent > 0 ? 2 * half / extent : 0;
+    float centerX = 0.5f * (minX + maxX), centerY = 0.5f * (minY + maxY);
+    for (PathPoint& point : points) {
+        point.x = arm.px + r + (point.x - centerX) * scale;
+        point.y = arm.py + (point.y - centerY) * scale;
+    }
+}
+
+/**
+ * Function to plan a time-parameterized joint trajectory along a path.
+ *
+ * The path, preceded by a straight move from the claw's current position, is
+ * resampled so consecutive samples are `speed` pixels apart, one per tick. IK
+ * for the samples is solved in chunks, one per pool worker, each unwrapped on
+ * its own; a serial pass then shifts each chunk by whole turns to continue the
+ * previous one, which makes the result independent of the thread count. The
+ * tracking error is the claw's distance from the path at every tick and
+ * halfway between ticks, where the joints are interpolated.
+ *
+ * @param path The mapped path (pixels).
+ * @param arm The arm that will trace it; its current pose starts the trajectory.
+ * @param speed The claw speed along the path (pixels per tick).
+ * @param pool The task pool solving the chunks; one that is not started solves them inline.
+ * @param trajectory The planned trajectory (output).
+ * @return True if every sample is reachable within the joint limits.
+ */
+bool planTrace(const std::vector<PathPoint>& path, const ArmState& arm, float speed, TaskPool& pool, TraceTrajectory& trajectory) {
+    ArmPose pose = computePose(arm);
+    std::vector<PathPoint>& points = trajectory.points;
+    points.clear();
+    points.push_back({pose.x3, pose.y3});
+
+    // Constant-speed resampling: carry the leftover distance across vertices
+    PathPoint from = points[0];
+    float carried = 0;
+    for (const PathPoint& to : path) {
+        float length = distance(from, to);
+        if (length <= 0) continue;
+        float s = speed - carried;
+        for (; s <= length; s += speed) {
+            float t = s / length;
+            points.push_back({from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t});
+        }
+        carried = length - (s - speed);
+        from = to;
+    }
+    if (distance(points.back(), path.back()) > 1e-3f) points.push_back(path.back());
+
+    size_t count = points.size();
+    unsigned threads = static_cast<unsigned>(std::clamp<size_t>(count / kMinChunk, 1, std::max(1u, pool.workerCount())));
+    trajectory.threads = threads;
+    trajectory.angles.resize(count);
+
+    bool elbowUp = std::sin(arm.currentAngle2) >= 0;
+    std::vector<size_t> unreachable(threads, 0);
+    auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(threads, [&](size_t i) {
+        size_t begin = count * i / threads, end = count * (i + 1) / threads;
+        solveChunk(points, arm, elbowUp, begin, end, trajectory.angles, unreachable[i]);
+    });
+    trajectory.solveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t failed = 0;
+    for (size_t value : unreachable) failed += value;
+    if (failed > 0) {
+        logWarning("Path has ", failed, " unreachable points");
+        return false;
+    }
+
+    // Stitch the chunks: the first continues from the current pose, each later one from the chunk before
+    for (unsigned i = 0; i < threads; ++i) {
+        size_t begin = count * i / threads, end = count * (i + 1) / threads;
+        ArmSolution reference = i == 0 ? ArmSolution{arm.currentAngle1, arm.currentAngle2} : trajectory.angles[begin - 1];
+        float turns1 = std::round((reference.angle1 - trajectory.angles[begin].angle1) / kTwoPi) * kTwoPi;
+        float turns2 = std::round((reference.angle2 - trajectory.angles[begin].angle2) / kTwoPi) * kTwoPi;
+        for (size_t j = begin; j < end; ++j) {
+            trajectory.angles[j].angle1 += turns1;
+            trajectory.angles[j].angle2 += turns2;
+        }
+    }
+
+    double squared = 0;
+    size_t measured = 0;
+    trajectory.maxError = 0;
+    trajectory.maxJointStep = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ArmSolution& angles = trajectory.angles[i];
+        if (!withinJointLimits(arm, angles.angle1, angles.angle2)) {
+            logWarning("Path violates the joint limits at point ", i);
+            return false;
+        }
+
+        float error = distance(forward(arm, angles), points[i]);
+        trajectory.maxError = std::max(trajectory.maxError, error);
+        squared += static_cast<double>(error) * error;
+        ++measured;
+
+        if (i + 1 < count) {
+            const ArmSolution& next = trajectory.angles[i + 1];
+            ArmSolution middle{0.5f * (angles.angle1 + next.angle1), 0.5f * (angles.angle2 + next.angle2)};
+            PathPoint target{0.5f * (points[i].x + points[i + 1].x), 0.5f * (points[i].y + points[i + 1].y)};
+            error = distance(forward(arm, middle), target);
+            trajectory.maxError = std::max(trajectory.maxError, error);
+            squared += static_cast<double>(error) * error;
+            ++measured;
+
+            float step = std::max(std::abs(next.angle1 - angles.angle1), std::abs(next.angle2 - angles.angle2));
+            trajectory.maxJointStep = std::max(trajectory.maxJointStep, step);
+        }
+    }
+    trajectory.rmsError = static_cast<float>(std::sqrt(squared / static_cast<double>(measured)));
+    return true;
+}
+
+void reportTrace(const TraceTrajectory& trajectory) {
+    double pointsPerSecond = trajectory.solveSeconds > 0 ? trajectory.points.size() / trajectory.solveSeconds : 0;
+    logInfo("Trace: ", trajectory.points.size(), " points solved in ", trajectory.solveSeconds * 1e3, " ms on ",
+            trajectory.threads, " threads (", pointsPerSecond, " points/s), tracking error max ", trajectory.maxError,
+            " px, rms ", trajectory.rmsError, " px, max joint step ", trajectory.maxJointStep, " rad/tick");
+    if (trajectory.maxError > kTraceTolerance) {
+        logWarning("Trace exceeds the ", kTraceTolerance, " px tolerance; lower the trace speed");
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef PATHTRACE_HPP
+#define PATHTRACE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Kinematics.h"
+
+struct ArmState;
+class TaskPool;
+
+struct PathPoint {
+    float x;
+    float y;
+};
+
+// Joint trajectory sampled once per tick, with the claw position it should produce
+struct TraceTrajectory {
+    std::vector<ArmSolution> angles;
+    std::vector<PathPoint> points;
+    unsigned threads = 0;     // Chunks solved in parallel
+    double solveSeconds = 0;  // Wall time of the parallel IK pass
+    float maxError = 0;       // Largest claw distance from the path, at and between ticks (pixels)
+    float rmsError = 0;
+    float maxJointStep = 0;   // Largest change of either joint in one tick (radians)
+};
+
+// Function to load a polyline ("x y" per line) or the first <path d="..."> of an SVG file
+bool loadPath(const std::string& filename, std::vector<PathPoint>& points);
+
+// Function to scale and move a path into the largest square the arm can reach everywhere
+void mapPathToWorkspace(std::vector<PathPoint>& points, const ArmState& arm);
+
+// Function to sample a path at constant speed and solve the joint trajectory in parallel chunks on the pool
+bool planTrace(const std::vector<PathPoint>& path, const ArmState& arm, float speed, TaskPool& pool, TraceTrajectory& trajectory);
+
+// Function to print the trajectory's solve throughput and tracking error
+void reportTrace(const TraceTrajectory& trajectory);
+
+#endif // PATHTRACE_HPP
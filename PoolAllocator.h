@@ -0,0 +1,87 @@
+#ifndef POOLALLOCATOR_HPP
+#define POOLALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * Free list of equally sized nodes, carved from chunks that are never returned
+ * to the heap. Once a workload has reached its largest node count, creating
+ * and destroying entities only moves nodes on and off the free list.
+ *
+ * One pool per node size and thread (local()); a node freed on another thread
+ * joins that thread's list, which is safe but moves it there for good.
+ */
+template <size_t Size, size_t Alignment>
+class NodePool {
+public:
+    static NodePool& local() {
+        thread_local NodePool pool;
+        return pool;
+    }
+
+    void* allocate() {
+        if (!freeList) grow();
+        Node* node = freeList;
+        freeList = node->next;
+        return node;
+    }
+
+    void deallocate(void* pointer) {
+        Node* node = static_cast<Node*>(pointer);
+        node->next = freeList;
+        freeList = node;
+    }
+
+private:
+    static constexpr size_t kNodesPerChunk = 64;
+
+    union Node {
+        Node* next;
+        alignas(Alignment) std::byte storage[Size];
+    };
+
+    void grow() {
+        chunks.push_back(std::make_unique<Node[]>(kNodesPerChunk));
+        Node* chunk = chunks.back().get();
+        for (size_t i = 0; i < kNodesPerChunk; ++i) deallocate(&chunk[i]);
+    }
+
+    Node* freeList = nullptr;
+    std::vector<std::unique_ptr<Node[]>> chunks;
+};
+
+/**
+ * Standard allocator that serves single objects from a NodePool, for
+ * node-based containers (std::list, std::map, ...) holding entities that come
+ * and go every few ticks. Array requests fall through to the heap.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        if (count != 1) return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+        return static_cast<T*>(NodePool<sizeof(T), alignof(T)>::local().allocate());
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        if (count != 1) {
+            ::operator delete(pointer, std::align_val_t(alignof(T)));
+            return;
+        }
+        NodePool<sizeof(T), alignof(T)>::local().deallocate(pointer);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+};
+
+#endif // POOLALLOCATOR_HPP
@@ -0,0 +1,104 @@
+#include "Replay.h"
+#include "Log.h"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+
+namespace {
+
+// Largest difference expected from quantization alone, per field
+float fieldTolerance(int field) {
+    double scale = field < 4 ? kTelemetryAngleScale : kTelemetryPixelScale;
+    return static_cast<float>(1.0 / scale);
+}
+
+const char* fieldName(int field) {
+    static const char* names[TelemetryFrame::kFieldCount] = {
+        "currentAngle1", "currentAngle2", "targetAngle1", "targetAngle2",
+        "tx", "ty", "px", "py", "L1", "L2", "trackX", "trackY",
+        "linearX0", "linearY0", "linearS"
+    };
+    return names[field];
+}
+
+} // namespace
+
+/**
+ * Function to re-simulate a recording headless and check it against the recorded states.
+ *
+ * Restores the exact state at the keyframe at or before startTick, then feeds
+ * the recorded commands through tickSimulation() as fast as the CPU allows and
+ * compares every resulting state with the recording. A solver change that
+ * alters behaviour shows up as the first diverging tick.
+ *
+ * @param replay An open recording.
+ * @param startTick The tick to start from (rounded down to a keyframe).
+ * @param params The simulation parameters the recording was made with.
+ * @return true if the re-simulation matched the recording.
+ */
+bool runHeadlessReplay(TelemetryReplay& replay, uint64_t startTick, const SimulationParams& params) {
+    TelemetryFrame recorded, simulated;
+    if (!replay.seekKeyframe(startTick, recorded)) return false;
+
+    ArmState arm;
+    restoreTelemetry(recorded, arm);
+    uint64_t firstTick = recorded.tick;
+
+    uint64_t ticks = 0;
+    uint64_t divergent = 0;
+    uint64_t firstDivergence = 0;
+    int firstField = -1;
+    float maxError = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (replay.next(recorded)) {
+        tickSimulation(arm, recorded.commands, params);
+        captureTelemetry(arm, simulated);
+        ++ticks;
+
+        bool match = simulated.elbowUp == recorded.elbowUp && simulated.tracking == recorded.tracking
+                     && simulated.linear == recorded.linear
+                     && simulated.itemGrabbed == recorded.itemGrabbed
+                     && simulated.items.size() == recorded.items.size();
+        int badField = match ? -1 : TelemetryFrame::kFieldCount;
+        for (int i = 0; i < TelemetryFrame::kFieldCount; ++i) {
+            float error = std::fabs(simulated.fields[i] - recorded.fields[i]);
+            if (i < 4) maxError = std::max(maxError, error);
+            if (error > fieldTolerance(i)) {
+                match = false;
+                if (badField < 0) badField = i;
+            }
+        }
+        for (size_t i = 0; match && i < recorded.items.size(); ++i) {
+            if (std::fabs(simulated.items[i].x - recorded.items[i].x) > fieldTolerance(4)
+                || std::fabs(simulated.items[i].y - recorded.items[i].y) > fieldTolerance(4)) {
+                match = false;
+            }
+        }
+
+        if (!match) {
+            if (divergent == 0) {
+                firstDivergence = recorded.tick;
+                firstField = badField;
+            }
+            ++divergent;
+            // Continue from the recorded state so one divergence is not reported for every later tick
+            restoreTelemetry(recorded, arm);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    logInfo("Replayed ", ticks, " ticks from tick ", firstTick, " in ", seconds, " s (",
+            seconds > 0 ? ticks / seconds : 0, " ticks/s), max angle error ", maxError, " rad");
+    if (divergent == 0) {
+        logInfo("Replay matches the recording");
+        return true;
+    }
+
+    std::string field;
+    if (firstField >= 0 && firstField < TelemetryFrame::kFieldCount) field = std::string(" (") + fieldName(firstField) + ")";
+    else if (firstField == TelemetryFrame::kFieldCount) field = " (flags/items)";
+    logWarning("Replay diverged in ", divergent, " ticks, first at tick ", firstDivergence, field);
+    return false;
+}
@@ -0,0 +1,11 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstdint>
+#include "Simulation.h"
+#include "TelemetryReplay.h"
+
+// Function to re-simulate a recording headless and check it against the recorded states
+bool runHeadlessReplay(TelemetryReplay& replay, uint64_t startTick, const SimulationParams& params);
+
+#endif // REPLAY_HPP
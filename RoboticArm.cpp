@@ -1,121 +1,124 @@
 #include "RoboticArm.h"
+#include "Simulation.h"
+#include "Conveyor.h"
+#include "PathTrace.h"
+#include "FrameArena.h"
 
-/**
- * Function to draw the grid on the window.
- *
- * This function draws a grid using the specified grid size, width, and height.
- * It draws vertical and horizontal lines to create the grid layout.
- *
- * @param window The window where the grid will be drawn.
- * @param width The width of the grid (in pixels).
- * @param height The height of the grid (in pixels).
- * @param gridSize The size of each grid square (in pixels).
- * @return none
- */
-void drawGrid(sf::RenderWindow& window, int width, int height, int gridSize) {
-    sf::VertexArray grid(sf::Lines);
+RenderStats renderStats;
 
-    // Draw vertical grid lines
-    for (int x = 0; x <= width; x += gridSize) {
-        grid.append(sf::Vertex(sf::Vector2f(x, 0), sf::Color(200, 200, 200)));
-        grid.append(sf::Vertex(sf::Vector2f(x, height), sf::Color(200, 200, 200)));
-    }
+namespace {
 
-    // Draw horizontal grid lines
-    for (int y = 0; y <= height; y += gridSize) {
-        grid.append(sf::Vertex(sf::Vector2f(0, y), sf::Color(200, 200, 200)));
-        grid.append(sf::Vertex(sf::Vector2f(width, y), sf::Color(200, 200, 200)));
+constexpr size_t kCirclePoints = 30; // Points on a circle's rim, as sf::CircleShape uses by default
+
+// Draws a circle from frame-arena vertices: a fan for the fill and, if thick, a strip for the
+// outline around it, the same geometry sf::CircleShape builds without allocating a shape
+void submitCircle(sf::RenderTarget& window, float x, float y, float radius, sf::Color fill, sf::Color outline,
+                  float outlineThickness) {
+    FrameArena::Scope scope(frameArena());
+    float step = 2 * 3.14159265f / kCirclePoints;
+
+    if (fill.a != 0) {
+        sf::Vertex* fan = frameArena().allocate<sf::Vertex>(kCirclePoints + 2);
+        fan[0] = sf::Vertex(sf::Vector2f(x, y), fill);
+        for (size_t i = 0; i <= kCirclePoints; ++i) {
+            float angle = static_cast<float>(i % kCirclePoints) * step - 3.14159265f / 2;
+            fan[i + 1] = sf::Vertex(sf::Vector2f(x + radius * std::cos(angle), y + radius * std::sin(angle)), fill);
+        }
+        submitVertices(window, fan, kCirclePoints + 2, sf::TriangleFan);
     }
 
-    // Draw the grid on the window
-    window.draw(grid);
+    if (outlineThickness != 0) {
+        sf::Vertex* strip = frameArena().allocate<sf::Vertex>(2 * (kCirclePoints + 1));
+        for (size_t i = 0; i <= kCirclePoints; ++i) {
+            float angle = static_cast<float>(i % kCirclePoints) * step - 3.14159265f / 2;
+            float c = std::cos(angle), s = std::sin(angle);
+            strip[2 * i] = sf::Vertex(sf::Vector2f(x + radius * c, y + radius * s), outline);
+            strip[2 * i + 1] = sf::Vertex(sf::Vector2f(x + (radius + outlineThickness) * c, y + (radius + outlineThickness) * s), outline);
+        }
+        submitVertices(window, strip, 2 * (kCirclePoints + 1), sf::TriangleStrip);
+    }
 }
 
+} // namespace
+
 /**
- * Function for linear interpolation between two values.
+ * Function to draw a shape and count what it submits.
  *
- * This function computes a linear interpolation between two values based on the interpolation factor 't'.
+ * SFML draws a shape's fill as a triangle fan of pointCount + 2 vertices and,
+ * if it has an outline, a triangle strip of 2 * (pointCount + 1) vertices.
  *
- * @param a The start value.
- * @param b The end value.
- * @param t The interpolation factor (between 0 and 1).
- * @return The interpolated value.
+ * @param window The render target where the shape will be drawn.
+ * @param shape The shape to draw.
+ * @return none
  */
-float lerp(float a, float b, float t) {
-    return a + (b - a) * t;
+void submitShape(sf::RenderTarget& window, const sf::Shape& shape) {
+    size_t points = shape.getPointCount();
+    renderStats.drawCalls += 1;
+    renderStats.vertices += points + 2;
+    if (shape.getOutlineThickness() != 0) {
+        renderStats.drawCalls += 1;
+        renderStats.vertices += 2 * (points + 1);
+    }
+    window.draw(shape);
+}
+
+void submitVertices(sf::RenderTarget& window, const sf::VertexArray& vertices) {
+    renderStats.drawCalls += 1;
+    renderStats.vertices += vertices.getVertexCount();
+    window.draw(vertices);
+}
+
+void submitVertices(sf::RenderTarget& window, const sf::Vertex* vertices, size_t count, sf::PrimitiveType type) {
+    renderStats.drawCalls += 1;
+    renderStats.vertices += count;
+    window.draw(vertices, count, type);
 }
 
 /**
- * Function to calculate the angles for the robotic arm's joints.
+ * Function to draw the grid on the window.
  *
- * This function uses inverse kinematics and the Law of Cosines to calculate
- * the angles required for the robotic arm to reach a target point.
+ * This function draws a grid using the specified grid size, width, and height.
+ * It draws vertical and horizontal lines to create the grid layout. The
+ * vertices live in the frame arena, so redrawing the grid every frame does not
+ * allocate.
  *
- * @param px The x-coordinate of the arm's pivot point.
- * @param py The y-coordinate of the arm's pivot point.
- * @param tx The x-coordinate of the target point.
- * @param ty The y-coordinate of the target point.
- * @param L1 The length of the first segment of the arm.
- * @param L2 The length of the second segment of the arm.
- * @param angle1 The calculated angle for the first joint (output).
- * @param angle2 The calculated angle for the second joint (output).
+ * @param window The render target where the grid will be drawn.
+ * @param width The width of the grid (in pixels).
+ * @param height The height of the grid (in pixels).
+ * @param gridSize The size of each grid square (in pixels).
  * @return none
  */
-void calculateArmAngles(float px, float py, float tx, float ty, float L1, float L2, float& angle1, float& angle2, bool& elbowUp) {
-    // Calculate the distance to the target
-    float dx = tx - px;
-    float dy = ty - py;
-    float distance = std::sqrt(dx * dx + dy * dy);
-
-    // Check if the target is within the reachable area
-    if (distance > L1 + L2 || distance < std::abs(L1 - L2)) {
-        std::cout << "Target is out of reach!\n";
-        return;
-    }
+void drawGrid(sf::RenderTarget& window, int width, int height, int gridSize) {
+    if (gridSize <= 0 || width < 0 || height < 0) return;
 
-    // Calculate the cosine of angle2 using the law of cosines
-    float cosAngle2 = (dx * dx + dy * dy - L1 * L1 - L2 * L2) / (2 * L1 * L2);
-    if (cosAngle2 < -1 || cosAngle2 > 1) {
-        std::cout << "Invalid target position\n";
-        return;
+    FrameArena::Scope scope(frameArena());
+    size_t count = 2 * static_cast<size_t>(width / gridSize + 1 + height / gridSize + 1);
+    sf::Vertex* grid = frameArena().allocate<sf::Vertex>(count);
+    size_t n = 0;
+
+    // Draw vertical grid lines
+    for (int x = 0; x <= width; x += gridSize) {
+        grid[n++] = sf::Vertex(sf::Vector2f(x, 0), sf::Color(200, 200, 200));
+        grid[n++] = sf::Vertex(sf::Vector2f(x, height), sf::Color(200, 200, 200));
     }
 
-    // Calculate both possible angles for angle2 (elbow-up and elbow-down)
-    float angle2_ElbowUp = std::acos(cosAngle2);   // Elbow-up configuration
-    float angle2_ElbowDown = -std::acos(cosAngle2); // Elbow-down configuration
-
-    // Calculate the first angle (angle1) for both configurations
-    float k1_ElbowUp = L1 + L2 * std::cos(angle2_ElbowUp);
-    float k2_ElbowUp = L2 * std::sin(angle2_ElbowUp);
-    float angle1_ElbowUp = std::atan2(dy, dx) - std::atan2(k2_ElbowUp, k1_ElbowUp);
-
-    float k1_ElbowDown = L1 + L2 * std::cos(angle2_ElbowDown);
-    float k2_ElbowDown = L2 * std::sin(angle2_ElbowDown);
-    float angle1_ElbowDown = std::atan2(dy, dx) - std::atan2(k2_ElbowDown, k1_ElbowDown);
-
-    // Choose the configuration that minimizes the total angular movement
-    float angleDiff_ElbowUp = std::abs(angle1_ElbowUp - angle1);
-    float angleDiff_ElbowDown = std::abs(angle1_ElbowDown - angle1);
-
-    // If elbow-down configuration results in a smaller total movement, use it
-    if (angleDiff_ElbowDown < angleDiff_ElbowUp) {
-        angle1 = angle1_ElbowDown;
-        angle2 = angle2_ElbowDown;
-        elbowUp = false; // Switch to elbow-down configuration
-    } else {
-        angle1 = angle1_ElbowUp;
-        angle2 = angle2_ElbowUp;
-        elbowUp = true; // Keep elbow-up configuration
+    // Draw horizontal grid lines
+    for (int y = 0; y <= height; y += gridSize) {
+        grid[n++] = sf::Vertex(sf::Vector2f(0, y), sf::Color(200, 200, 200));
+        grid[n++] = sf::Vertex(sf::Vector2f(width, y), sf::Color(200, 200, 200));
     }
+
+    // Draw the grid on the window
+    submitVertices(window, grid, n, sf::Lines);
 }
 
 /**
  * Function to draw a thick line between two points.
  *
  * This function draws a line between two points with a specified color and thickness.
- * It uses a rectangle shape to simulate a thick line.
+ * It draws a quad from frame-arena vertices to simulate a thick line.
  *
- * @param window The window where the line will be drawn.
+ * @param window The render target where the line will be drawn.
  * @param x1 The x-coordinate of the starting point.
  * @param y1 The y-coordinate of the starting point.
  * @param x2 The x-coordinate of the ending point.
@@ -124,18 +127,23 @@ void calculateArmAngles(float px, float py, float tx, float ty, float L1, float
  * @param thickness The thickness of the line.
  * @return none
  */
-void drawThickLine(sf::RenderWindow& window, float x1, float y1, float x2, float y2, sf::Color color, float thickness) {
+void drawThickLine(sf::RenderTarget& window, float x1, float y1, float x2, float y2, sf::Color color, float thickness) {
     sf::Vector2f direction(x2 - x1, y2 - y1);
     float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
 
     if (length == 0) return; // Avoid division by zero
 
-    sf::RectangleShape line(sf::Vector2f(length, thickness));
-    line.setFillColor(color);
-    line.setOrigin(0, thickness / 2);
-    line.setPosition(x1, y1);
-    line.setRotation(std::atan2(direction.y, direction.x) * 180 / 3.14159f); // Convert radians to degrees
-    window.draw(line);
+    // Half the thickness to either side of the line
+    float nx = -direction.y / length * thickness / 2;
+    float ny = direction.x / length * thickness / 2;
+
+    FrameArena::Scope scope(frameArena());
+    sf::Vertex* quad = frameArena().allocate<sf::Vertex>(4);
+    quad[0] = sf::Vertex(sf::Vector2f(x1 + nx, y1 + ny), color);
+    quad[1] = sf::Vertex(sf::Vector2f(x2 + nx, y2 + ny), color);
+    quad[2] = sf::Vertex(sf::Vector2f(x2 - nx, y2 - ny), color);
+    quad[3] = sf::Vertex(sf::Vector2f(x1 - nx, y1 - ny), color);
+    submitVertices(window, quad, 4, sf::Quads);
 }
 
 /**
@@ -144,7 +152,7 @@ void drawThickLine(sf::RenderWindow& window, float x1, float y1, float x2, float
  * This function draws a simple claw mechanism at the end of the second arm segment.
  * The claw consists of two "fingers" represented as thick lines rotated to face the target.
  *
- * @param window The window where the claw will be drawn.
+ * @param window The render target where the claw will be drawn.
  * @param x The x-coordinate of the center of the claw.
  * @param y The y-coordinate of the center of the claw.
  * @param angle The angle of the arm (used to rotate the claw to align with the arm).
@@ -154,7 +162,7 @@ void drawThickLine(sf::RenderWindow& window, float x1, float y1, float x2, float
  * @return none
  */
 
-void drawClaw(sf::RenderWindow& window, float x, float y, float angle, float length, float width, sf::Color color) {
+void drawClaw(sf::RenderTarget& window, float x, float y, float angle, float length, float width, sf::Color color) {
     // Create two lines for the claw fingers
     // Both fingers should have the same length and be rotated symmetrically
     sf::Vector2f claw1(x + length * std::cos(angle - M_PI_4), y + length * std::sin(angle - M_PI_4)); // First finger
@@ -166,41 +174,143 @@ void drawClaw(sf::RenderWindow& window, float x, float y, float angle, float len
 }
 
 
-void drawJoint(sf::RenderWindow& window, float x, float y) {
+void drawJoint(sf::RenderTarget& window, float x, float y) {
     float offset = 7;
-    sf::CircleShape joint(offset);
-    joint.setFillColor(sf::Color::Black);
-    joint.setOutlineColor(sf::Color::Black);
-    joint.setPosition(x-offset, y-offset);
-    window.draw(joint);
+    submitCircle(window, x, y, offset, sf::Color::Black, sf::Color::Black, 0);
 }
 
-void drawMinReachCircle(sf::RenderWindow& window, float x, float y, float L1, float L2) {
+void drawMinReachCircle(sf::RenderTarget& window, float x, float y, float L1, float L2) {
     float minReach = std::max(0.0f, L1 - L2);  // Ensure non-negative minimum reach
-    sf::CircleShape minReachCircle(minReach);
-    minReachCircle.setFillColor(sf::Color::Transparent);
-    minReachCircle.setOutlineColor(sf::Color::Black);
-    minReachCircle.setOutlineThickness(1);
-    minReachCircle.setPosition(x - minReach, y - minReach); // Center the circle at (px, py)
-    window.draw(minReachCircle);
+    submitCircle(window, x, y, minReach, sf::Color::Transparent, sf::Color::Black, 1); // Centered at (px, py)
 }
 
-void drawMaxReachCircle(sf::RenderWindow& window, float x, float y, float L1, float L2) {
+void drawMaxReachCircle(sf::RenderTarget& window, float x, float y, float L1, float L2) {
     float maxReach = L1 + L2; // Maximum reach is the sum of both arm segments
-    sf::CircleShape maxReachCircle(maxReach);
-    maxReachCircle.setFillColor(sf::Color::Transparent);
-    maxReachCircle.setOutlineColor(sf::Color::Red);
-    maxReachCircle.setOutlineThickness(1);
-    maxReachCircle.setPosition(x - maxReach, y - maxReach); // Center the circle at (px, py)
-    window.draw(maxReachCircle);
+    submitCircle(window, x, y, maxReach, sf::Color::Transparent, sf::Color::Red, 1); // Centered at (px, py)
 }
 
-void drawZeroPoint(sf::RenderWindow& window, float x2, float y2) {
+void drawZeroPoint(sf::RenderTarget& window, float x2, float y2) {
     float offset = 7;
-    sf::CircleShape joint(offset);
-    joint.setFillColor(sf::Color::Black);
-    joint.setOutlineColor(sf::Color::Black);
-    joint.setPosition(x2-offset, y2-offset);
-    window.draw(joint);
+    submitCircle(window, x2, y2, offset, sf::Color::Black, sf::Color::Black, 0);
+}
+
+void drawObstacle(sf::RenderTarget& window, float x, float y, float radius) {
+    submitCircle(window, x, y, radius, sf::Color(160, 160, 160), sf::Color::Transparent, 0);
 }
 
+/**
+ * Function to draw a complete arm in its current pose.
+ *
+ * Draws both links, the claw, the elbow joint and the pivot.
+ *
+ * @param window The render target where the arm will be drawn.
+ * @param arm The arm state (pivot and angles).
+ * @param pose The joint positions of the arm.
+ * @param thickness The thickness of the links.
+ * @param clawLength The length of each claw finger.
+ * @param clawWidth The width of the claw fingers.
+ * @return none
+ */
+void drawArm(sf::RenderTarget& window, const ArmState& arm, const ArmPose& pose, float thickness, float clawLength, float clawWidth) {
+    drawThickLine(window, arm.px, arm.py, pose.x2, pose.y2, sf::Color::Blue, thickness); // Upper arm
+    drawThickLine(window, pose.x2, pose.y2, pose.x3, pose.y3, sf::Color::Red, thickness);  // Lower arm
+    // Draw the claw at the end of the arm (second segment)
+    drawClaw(window, pose.x3, pose.y3, arm.currentAngle1 + arm.currentAngle2, clawLength, clawWidth, sf::Color::Black);
+    drawJoint(window, pose.x2, pose.y2);
+    drawZeroPoint(window, arm.px, arm.py);
+}
+
+sf::VertexArray makeItemVertices(const SceneItem* items, size_t count) {
+    sf::VertexArray vertices(sf::Quads);
+    float r = 3.0f;
+    for (size_t i = 0; i < count; ++i) {
+        const SceneItem& item = items[i];
+        vertices.append(sf::Vertex(sf::Vector2f(item.x - r, item.y - r), sf::Color::Black));
+        vertices.append(sf::Vertex(sf::Vector2f(item.x + r, item.y - r), sf::Color::Black));
+        vertices.append(sf::Vertex(sf::Vector2f(item.x + r, item.y + r), sf::Color::Black));
+        vertices.append(sf::Vertex(sf::Vector2f(item.x - r, item.y + r), sf::Color::Black));
+    }
+    return vertices;
+}
+
+/**
+ * Function to draw one frame of the scene.
+ *
+ * Draws the grid, obstacles, static scene items, every arm, the reach circles
+ * of the interactive arm (arms[0]) and the placed items. Shared by the window
+ * loop and the frame-time benchmark so both measure the same work.
+ *
+ * @param window The render target where the scene will be drawn.
+ * @param arms The arms; arms[0] is the interactive arm.
+ * @param params The simulation parameters (grid size, claw and link sizes).
+ * @param obstacles The scene obstacles.
+ * @param obstacleCount The number of obstacles.
+ * @param sceneItems Prebuilt vertices of the static scene items.
+ * @param width The width of the drawn area (in pixels).
+ * @param height The height of the drawn area (in pixels).
+ * @return none
+ */
+void drawScene(sf::RenderTarget& window, const std::vector<ArmState>& arms, const SimulationParams& params,
+               const SceneObstacle* obstacles, size_t obstacleCount, const sf::VertexArray& sceneItems,
+               unsigned width, unsigned height) {
+    window.clear(sf::Color::White);
+    drawGrid(window, width, height, params.gridSize);
+
+    for (size_t i = 0; i < obstacleCount; ++i) {
+        drawObstacle(window, obstacles[i].x, obstacles[i].y, obstacles[i].radius);
+    }
+    if (sceneItems.getVertexCount() > 0) submitVertices(window, sceneItems);
+
+    // Show the line of a Cartesian-linear move
+    if (arms[0].linear) {
+        drawThickLine(window, arms[0].linearX0, arms[0].linearY0, arms[0].tx, arms[0].ty, sf::Color(120, 160, 255), 1.0f);
+    }
+
+    // Draw robotic arms with smooth transition
+    for (const ArmState& arm : arms) {
+        drawArm(window, arm, computePose(arm, params.fkTrig), params.thickness, params.clawLength, params.clawWidth);
+    }
+
+    const ArmState& arm = arms[0];
+
+    // Draw the minimum reach circle (radius L1 - L2)
+    drawMinReachCircle(window, arm.px, arm.py, arm.L1, arm.L2);
+
+    // Draw the maximum reach circle (radius L1 + L2)
+    drawMaxReachCircle(window, arm.px, arm.py, arm.L1, arm.L2);
+
+    for (const auto& item : items) {
+        submitShape(window, item);
+    }
+}
+
+/**
+ * Function to draw the conveyor belt, its items and the predicted intercept.
+ *
+ * @param window The render target where the conveyor will be drawn.
+ * @param conveyor The belt state.
+ * @return none
+ */
+void drawConveyor(sf::RenderTarget& window, const ConveyorState& conveyor) {
+    const ConveyorParams& belt = conveyor.params;
+
+    drawThickLine(window, belt.startX, belt.beltY, belt.endX, belt.beltY, sf::Color(170, 170, 170), 14.0f);
+
+    submitCircle(window, belt.dropX, belt.dropY, 6.0f, sf::Color::Transparent, sf::Color(0, 150, 0), 2.0f);
+
+    for (const ConveyorItem& onBelt : conveyor.belt) {
+        submitCircle(window, onBelt.x, onBelt.y, 5.0f, sf::Color::Black, sf::Color::Transparent, 0);
+    }
+
+    if (conveyor.target >= 0 && !conveyor.belt[conveyor.target].carried) {
+        submitCircle(window, conveyor.interceptX, conveyor.interceptY, 3.0f, sf::Color::Red, sf::Color::Transparent, 0);
+    }
+}
+
+sf::VertexArray makePathVertices(const std::vector<PathPoint>& points) {
+    sf::VertexArray vertices(sf::LineStrip, points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        vertices[i] = sf::Vertex(sf::Vector2f(points[i].x, points[i].y), sf::Color(120, 160, 255));
+    }
+    return vertices;
+}
@@ -4,29 +4,66 @@
 #include <SFML/Graphics.hpp>
 #include <cmath>
 #include <iostream>
+#include <cstdint>
+#include <vector>
+#include "Kinematics.h"
 
-// Function to draw the grid on the window
-void drawGrid(sf::RenderWindow& window, int width, int height, int gridSize);
+// What the draw helpers submitted to the GPU since the counters were last reset
+struct RenderStats {
+    uint64_t drawCalls = 0;
+    uint64_t vertices = 0;
+};
+
+extern RenderStats renderStats;
 
-// Function for linear interpolation between two values
-float lerp(float a, float b, float t);
+// Functions to draw a shape or vertex array and count the submitted draw calls and vertices
+void submitShape(sf::RenderTarget& window, const sf::Shape& shape);
+void submitVertices(sf::RenderTarget& window, const sf::VertexArray& vertices);
+void submitVertices(sf::RenderTarget& window, const sf::Vertex* vertices, size_t count, sf::PrimitiveType type);
 
-// Function to calculate the angles for the robotic arm's joints
-void calculateArmAngles(float px, float py, float tx, float ty, float L1, float L2, float& angle1, float& angle2, bool& elbowUp);
+// Function to draw the grid on the window
+void drawGrid(sf::RenderTarget& window, int width, int height, int gridSize);
 
 // Function to draw a thick line between two points
-void drawThickLine(sf::RenderWindow& window, float x1, float y1, float x2, float y2, sf::Color color, float thickness);
+void drawThickLine(sf::RenderTarget& window, float x1, float y1, float x2, float y2, sf::Color color, float thickness);
 
-void drawClaw(sf::RenderWindow& window, float x, float y, float angle, float length, float width, sf::Color color);
+void drawClaw(sf::RenderTarget& window, float x, float y, float angle, float length, float width, sf::Color color);
 
-void drawJoint(sf::RenderWindow& window, float x, float y);
+void drawJoint(sf::RenderTarget& window, float x, float y);
 
-void drawMinReachCircle(sf::RenderWindow& window, float x, float y, float L1, float L2);
+void drawMinReachCircle(sf::RenderTarget& window, float x, float y, float L1, float L2);
 
-void drawMaxReachCircle(sf::RenderWindow& window, float x, float y, float L1, float L2);
+void drawMaxReachCircle(sf::RenderTarget& window, float x, float y, float L1, float L2);
 
-void drawZeroPoint(sf::RenderWindow& window, float x2, float y2);
+void drawZeroPoint(sf::RenderTarget& window, float x2, float y2);
 
 void drawItem(int x, int y);
 
+void drawObstacle(sf::RenderTarget& window, float x, float y, float radius);
+
+struct ArmState;
+struct ArmPose;
+struct SimulationParams;
+struct SceneObstacle;
+struct SceneItem;
+struct ConveyorState;
+struct PathPoint;
+
+// Function to build the vertices of static scene items once, for drawing in a single batch
+sf::VertexArray makeItemVertices(const SceneItem* items, size_t count);
+
+// Function to draw a complete arm (links, claw and joints) in its current pose
+void drawArm(sf::RenderTarget& window, const ArmState& arm, const ArmPose& pose, float thickness, float clawLength, float clawWidth);
+
+// Function to draw one frame of the scene (grid, obstacles, items and all arms)
+void drawScene(sf::RenderTarget& window, const std::vector<ArmState>& arms, const SimulationParams& params,
+               const SceneObstacle* obstacles, size_t obstacleCount, const sf::VertexArray& sceneItems,
+               unsigned width, unsigned height);
+
+// Function to build the line strip of a path being traced, for drawing in a single batch
+sf::VertexArray makePathVertices(const std::vector<PathPoint>& points);
+
+// Function to draw the conveyor belt, its items and the predicted intercept
+void drawConveyor(sf::RenderTarget& window, const ConveyorState& conveyor);
+
 #endif // ROBOTICARM_HPP
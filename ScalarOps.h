@@ -0,0 +1,174 @@
+#ifndef SCALAROPS_HPP
+#define SCALAROPS_HPP
+
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include "FastMath.h"
+
+/*
+ * Scalar types the kinematics templates are built for, and the math each one
+ * uses. float and double use the standard library; double is the reference
+ * for validation. FloatLanes holds kWidth independent floats in a GCC/Clang
+ * vector type as wide as the target's SIMD registers, so every operator is one
+ * instruction, and its math is the FastMath kernels rewritten with lane
+ * selects instead of branches. Each lane gives the same result as the scalar
+ * kernel. Build with -mavx (or -march=native) for 8 lanes instead of 4.
+ */
+
+// Comparison result of FloatLanes, one flag per lane
+struct LaneMask {
+#ifdef __AVX__
+    static constexpr int kWidth = 8;
+#else
+    static constexpr int kWidth = 4; // SSE/NEON registers; GCC splits wider compares into scalar code
+#endif
+    typedef int32_t Vector __attribute__((vector_size(kWidth * sizeof(int32_t))));
+    Vector lane; // 0 or -1, like a SIMD compare
+
+    LaneMask operator&(const LaneMask& other) const { return {lane & other.lane}; }
+};
+
+// kWidth floats processed together; a float converts by broadcasting to every lane
+struct FloatLanes {
+    static constexpr int kWidth = LaneMask::kWidth;
+    typedef float Vector __attribute__((vector_size(kWidth * sizeof(float))));
+    Vector lane;
+
+    FloatLanes() = default;
+    FloatLanes(float value) : lane(Vector{} + value) {}
+    explicit FloatLanes(Vector value) : lane(value) {}
+
+    FloatLanes operator-() const { return FloatLanes(-lane); }
+};
+
+#define FLOATLANES_OPERATOR(op)                                                  \
+    inline FloatLanes operator op(const FloatLanes& a, const FloatLanes& b) {    \
+        return FloatLanes(a.lane op b.lane);                                     \
+    }
+FLOATLANES_OPERATOR(+)
+FLOATLANES_OPERATOR(-)
+FLOATLANES_OPERATOR(*)
+FLOATLANES_OPERATOR(/)
+#undef FLOATLANES_OPERATOR
+
+#define FLOATLANES_COMPARISON(op)                                                \
+    inline LaneMask operator op(const FloatLanes& a, const FloatLanes& b) {      \
+        return {a.lane op b.lane};                                               \
+    }
+FLOATLANES_COMPARISON(<)
+FLOATLANES_COMPARISON(<=)
+FLOATLANES_COMPARISON(>)
+FLOATLANES_COMPARISON(>=)
+#undef FLOATLANES_COMPARISON
+
+// Math of a kinematics scalar type; only the specializations below exist
+template <typename T>
+struct ScalarOps;
+
+template <std::floating_point T>
+struct ScalarOps<T> {
+    using Mask = bool;
+
+    static T sqrt(T x) { return std::sqrt(x); }
+    static T abs(T x) { return std::abs(x); }
+    static T min(T a, T b) { return a < b ? a : b; }
+    static T max(T a, T b) { return a > b ? a : b; }
+    static T sin(T x) { return std::sin(x); }
+    static T cos(T x) { return std::cos(x); }
+    static T acos(T x) { return std::acos(x); }
+    static T atan2(T y, T x) { return std::atan2(y, x); }
+};
+
+// FastMath accuracy: |error| < 3e-7 for sin/cos, 2e-8 for acos before rounding, 1e-5 rad for atan2
+template <>
+struct ScalarOps<FloatLanes> {
+    using Mask = LaneMask;
+    using Vector = FloatLanes::Vector;
+    using Bits = LaneMask::Vector;
+
+    // Function to pick a where the mask is set and b elsewhere. Bitwise, since GCC
+    // splits `mask ? a : b` into scalar branches when the vector is wider than the target's registers.
+    static Vector select(Bits mask, Vector a, Vector b) {
+        return __builtin_bit_cast(Vector, (mask & __builtin_bit_cast(Bits, a)) | (~mask & __builtin_bit_cast(Bits, b)));
+    }
+    static Vector broadcast(float value) { return Vector{} + value; }
+
+    // fastRsqrt and fastSqrt
+    static Vector sqrtLanes(Vector x) {
+        Bits bits = 0x5F375A86 - (__builtin_bit_cast(Bits, x) >> 1); // Sign bit is clear where x > 0
+        Vector y = __builtin_bit_cast(Vector, bits);
+        y = y * (1.5f - 0.5f * x * y * y);
+        y = y * (1.5f - 0.5f * x * y * y);
+        return select(x > 0, x * y, broadcast(0.0f));
+    }
+
+    static Vector absLanes(Vector x) { return select(x < 0, -x, x); }
+
+    // fastAcos
+    static Vector acosLanes(Vector x) {
+        Vector ax = absLanes(x);
+        Vector p = 1.5707963050f + ax * (-0.2145988016f + ax * (0.0889789874f + ax * (-0.0501743046f
+                   + ax * (0.0308918810f + ax * (-0.0170881256f + ax * (0.0066700901f + ax * -0.0012624911f))))));
+        Vector r = sqrtLanes(1.0f - ax) * p;
+        return select(x < 0, 3.14159274f - r, r);
+    }
+
+    // fastAtan2; where x and y are both zero z is 0, so the result is 0 like the scalar early return
+    static Vector atan2Lanes(Vector y, Vector x) {
+        Vector ax = absLanes(x);
+        Vector ay = absLanes(y);
+        Vector mx = select(ax > ay, ax, ay);
+        Vector mn = select(ax > ay, ay, ax);
+        Vector z = mn / select(mx == 0, broadcast(1.0f), mx);
+        Vector z2 = z * z;
+        Vector r = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+        r = select(ay > ax, 1.57079637f - r, r);
+        r = select(x < 0, 3.14159274f - r, r);
+        return select(y < 0, -r, r);
+    }
+
+    // fastSinCos
+    static void sinCosLanes(Vector x, Vector& s, Vector& c) {
+        Vector k = x * 0.318309886f;
+        k = (k + 12582912.0f) - 12582912.0f;
+        Vector r = ((x - k * 3.140625f) - k * 9.67502593994140625e-4f) - k * 1.509957990978376432e-7f;
+        Bits quadrant = __builtin_convertvector(k, Bits);
+        Vector sign = __builtin_convertvector(1 - 2 * (quadrant & 1), Vector);
+        Vector r2 = r * r;
+        s = sign * r * (1.0f + r2 * (-1.66666667e-1f + r2 * (8.33333333e-3f + r2 * (-1.98412698e-4f
+            + r2 * (2.75573192e-6f + r2 * -2.50521084e-8f)))));
+        c = sign * (1.0f + r2 * (-0.5f + r2 * (4.16666667e-2f + r2 * (-1.38888889e-3f + r2 * (2.48015873e-5f
+            + r2 * (-2.75573192e-7f + r2 * 2.08767570e-9f))))));
+    }
+
+    static FloatLanes sqrt(const FloatLanes& x) { return FloatLanes(sqrtLanes(x.lane)); }
+    static FloatLanes abs(const FloatLanes& x) { return FloatLanes(absLanes(x.lane)); }
+    static FloatLanes acos(const FloatLanes& x) { return FloatLanes(acosLanes(x.lane)); }
+    static FloatLanes atan2(const FloatLanes& y, const FloatLanes& x) { return FloatLanes(atan2Lanes(y.lane, x.lane)); }
+
+    static FloatLanes sin(const FloatLanes& x) {
+        Vector s, c;
+        sinCosLanes(x.lane, s, c);
+        return FloatLanes(s);
+    }
+
+    static FloatLanes cos(const FloatLanes& x) {
+        Vector s, c;
+        sinCosLanes(x.lane, s, c);
+        return FloatLanes(c);
+    }
+
+    static FloatLanes min(const FloatLanes& a, const FloatLanes& b) { return FloatLanes(select(a.lane < b.lane, a.lane, b.lane)); }
+    static FloatLanes max(const FloatLanes& a, const FloatLanes& b) { return FloatLanes(select(a.lane > b.lane, a.lane, b.lane)); }
+};
+
+// A type the kinematics templates accept
+template <typename T>
+concept KinematicsScalar = requires { typename ScalarOps<T>::Mask; };
+
+// A kinematics type with one value per variable, so it can branch
+template <typename T>
+concept KinematicsReal = KinematicsScalar<T> && std::floating_point<T>;
+
+#endif // SCALAROPS_HPP
@@ -0,0 +1,118 @@
+#include "Scene.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+uint64_t alignUp(uint64_t value) {
+    return (value + kSceneAlignment - 1) & ~(kSceneAlignment - 1);
+}
+
+bool arrayFits(uint64_t offset, uint64_t count, uint64_t recordSize, uint64_t fileSize) {
+    return offset % kSceneAlignment == 0 && offset <= fileSize && count <= (fileSize - offset) / recordSize;
+}
+
+} // namespace
+
+Scene::~Scene() {
+    close();
+}
+
+/**
+ * Function to map a scene file.
+ *
+ * @param path The binary scene file (see scene_convert).
+ * @return true if the file is a valid scene.
+ */
+bool Scene::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        logError("Failed to open scene ", path, ": ", std::strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(SceneHeader)) {
+        logError("Scene ", path, " is too small");
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        logError("Failed to map scene ", path, ": ", std::strerror(errno));
+        return false;
+    }
+
+    const auto* candidate = static_cast<const SceneHeader*>(memory);
+    bool valid = candidate->magic == kSceneMagic && candidate->version == kSceneVersion
+                 && candidate->fileSize == size
+                 && arrayFits(candidate->armsOffset, candidate->armCount, sizeof(SceneArm), size)
+                 && arrayFits(candidate->obstaclesOffset, candidate->obstacleCount, sizeof(SceneObstacle), size)
+                 && arrayFits(candidate->itemsOffset, candidate->itemCount, sizeof(SceneItem), size);
+    if (!valid) {
+        logError("Scene ", path, " is not a valid version ", kSceneVersion, " scene");
+        ::munmap(memory, size);
+        return false;
+    }
+
+    header = candidate;
+    mappedSize = size;
+    return true;
+}
+
+void Scene::close() {
+    if (!header) return;
+    ::munmap(const_cast<SceneHeader*>(header), mappedSize);
+    header = nullptr;
+    mappedSize = 0;
+}
+
+/**
+ * Function to write a scene file.
+ *
+ * @param path The output file.
+ * @param header Scene-wide settings (grid size, window size); counts and offsets are computed.
+ * @param arms The arms of the scene.
+ * @param obstacles The obstacles of the scene.
+ * @param items The items of the scene.
+ * @return true if the file was written.
+ */
+bool writeScene(const std::string& path, SceneHeader header, const std::vector<SceneArm>& arms,
+                const std::vector<SceneObstacle>& obstacles, const std::vector<SceneItem>& items) {
+    header.magic = kSceneMagic;
+    header.version = kSceneVersion;
+    header.reserved = 0;
+    header.armCount = static_cast<uint32_t>(arms.size());
+    header.obstacleCount = static_cast<uint32_t>(obstacles.size());
+    header.itemCount = items.size();
+    header.armsOffset = alignUp(sizeof(SceneHeader));
+    header.obstaclesOffset = alignUp(header.armsOffset + arms.size() * sizeof(SceneArm));
+    header.itemsOffset = alignUp(header.obstaclesOffset + obstacles.size() * sizeof(SceneObstacle));
+    header.fileSize = header.itemsOffset + items.size() * sizeof(SceneItem);
+
+    std::vector<char> buffer(header.fileSize, 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    if (!arms.empty()) std::memcpy(buffer.data() + header.armsOffset, arms.data(), arms.size() * sizeof(SceneArm));
+    if (!obstacles.empty()) std::memcpy(buffer.data() + header.obstaclesOffset, obstacles.data(), obstacles.size() * sizeof(SceneObstacle));
+    if (!items.empty()) std::memcpy(buffer.data() + header.itemsOffset, items.data(), items.size() * sizeof(SceneItem));
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        logError("Failed to create scene ", path, ": ", std::strerror(errno));
+        return false;
+    }
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
@@ -0,0 +1,49 @@
+#ifndef SCENE_HPP
+#define SCENE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "SceneFormat.h"
+
+/**
+ * A memory-mapped binary scene.
+ *
+ * open() maps the file and validates the header and array bounds; there is no
+ * parsing, the accessors point straight into the mapping.
+ */
+class Scene {
+public:
+    Scene() = default;
+    ~Scene();
+
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    const SceneHeader& info() const { return *header; }
+    const SceneArm* arms() const { return header ? arrayAt<SceneArm>(header->armsOffset) : nullptr; }
+    const SceneObstacle* obstacles() const { return header ? arrayAt<SceneObstacle>(header->obstaclesOffset) : nullptr; }
+    const SceneItem* items() const { return header ? arrayAt<SceneItem>(header->itemsOffset) : nullptr; }
+    size_t armCount() const { return header ? header->armCount : 0; }
+    size_t obstacleCount() const { return header ? header->obstacleCount : 0; }
+    size_t itemCount() const { return header ? header->itemCount : 0; }
+
+private:
+    template <typename T>
+    const T* arrayAt(uint64_t offset) const {
+        return reinterpret_cast<const T*>(reinterpret_cast<const char*>(header) + offset);
+    }
+
+    const SceneHeader* header = nullptr;
+    size_t mappedSize = 0;
+};
+
+// Function to write a scene file; header counts, offsets and size are filled in
+bool writeScene(const std::string& path, SceneHeader header, const std::vector<SceneArm>& arms,
+                const std::vector<SceneObstacle>& obstacles, const std::vector<SceneItem>& items);
+
+#endif // SCENE_HPP
@@ -0,0 +1,56 @@
+#ifndef SCENEFORMAT_HPP
+#define SCENEFORMAT_HPP
+
+#include <cstdint>
+
+/*
+ * Binary scene file (*.arms), designed to be mmap'ed and used in place.
+ *
+ * A fixed SceneHeader is followed by three tightly packed arrays of POD
+ * records (arms, obstacles, items). Each array starts on a 64-byte boundary
+ * at the offset given in the header. All values are native endian; angles
+ * are radians.
+ */
+
+constexpr uint32_t kSceneMagic = 0x4E435341; // "ASCN"
+constexpr uint32_t kSceneVersion = 1;
+constexpr uint64_t kSceneAlignment = 64;
+
+struct SceneHeader {
+    uint32_t magic;
+    uint32_t version;
+    float gridSize;
+    float width, height;   // Window size in pixels
+    uint32_t armCount;
+    uint32_t obstacleCount;
+    uint32_t reserved;
+    uint64_t itemCount;
+    uint64_t armsOffset;
+    uint64_t obstaclesOffset;
+    uint64_t itemsOffset;
+    uint64_t fileSize;
+};
+
+struct SceneArm {
+    float px, py;               // Pivot
+    float L1, L2;               // Link lengths
+    float minAngle1, maxAngle1; // Joint limits of the shoulder
+    float minAngle2, maxAngle2; // Joint limits of the elbow
+};
+
+struct SceneObstacle {
+    float x, y;
+    float radius;
+    uint32_t reserved;
+};
+
+struct SceneItem {
+    float x, y;
+};
+
+static_assert(sizeof(SceneHeader) == 72, "SceneHeader layout");
+static_assert(sizeof(SceneArm) == 32, "SceneArm layout");
+static_assert(sizeof(SceneObstacle) == 16, "SceneObstacle layout");
+static_assert(sizeof(SceneItem) == 8, "SceneItem layout");
+
+#endif // SCENEFORMAT_HPP
@@ -0,0 +1,83 @@
+#ifndef SHAREDSTATE_HPP
+#define SHAREDSTATE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+/*
+ * Layout of the shared-memory state ring written by StatePublisher.
+ *
+ * The simulator writes one SharedArmFrame per tick into slot (tick % kStateSlots)
+ * under a per-slot sequence counter (seqlock): the counter is odd while the slot
+ * is being written. Readers never block the writer; they read a slot in place
+ * between beginStateRead() and endStateRead() and retry if the sequence changed.
+ * This header has no dependencies so external viewers can include it directly.
+ */
+
+constexpr uint32_t kStateMagic = 0x54535241; // "ARST"
+constexpr uint32_t kStateVersion = 1;
+constexpr uint32_t kStateSlots = 16;
+constexpr uint32_t kMaxPublishedItems = 64;
+
+struct SharedItem {
+    float x;
+    float y;
+};
+
+struct SharedArmFrame {
+    uint64_t tick;
+    float angle1, angle2;   // current joint angles (radians)
+    float x2, y2;           // elbow position (pixels)
+    float x3, y3;           // end effector position (pixels)
+    uint32_t itemGrabbed;
+    uint32_t itemCount;     // number of valid entries in items
+    SharedItem items[kMaxPublishedItems];
+};
+
+struct alignas(64) SharedStateSlot {
+    std::atomic<uint32_t> sequence;
+    SharedArmFrame frame;
+};
+
+struct SharedStateHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t frameSize;
+    alignas(64) std::atomic<uint64_t> latestTick; // tick of the newest complete frame, ~0 if none
+    SharedStateSlot slots[kStateSlots];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock needs lock-free atomics in shared memory");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs lock-free atomics in shared memory");
+
+// Start reading a slot in place. Returns the sequence to pass to endStateRead().
+inline uint32_t beginStateRead(const SharedStateSlot& slot) {
+    uint32_t sequence;
+    while ((sequence = slot.sequence.load(std::memory_order_acquire)) & 1u) {
+        // Writer is inside the slot; spin until it finishes
+    }
+    return sequence;
+}
+
+// Returns true if the slot was not modified since beginStateRead().
+inline bool endStateRead(const SharedStateSlot& slot, uint32_t sequence) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+// Convenience reader: copy the newest frame. Returns false if nothing was published yet.
+inline bool readLatestArmFrame(const SharedStateHeader& header, SharedArmFrame& out) {
+    for (;;) {
+        uint64_t tick = header.latestTick.load(std::memory_order_acquire);
+        if (tick == ~0ull) return false;
+
+        const SharedStateSlot& slot = header.slots[tick % kStateSlots];
+        uint32_t sequence = beginStateRead(slot);
+        std::memcpy(&out, &slot.frame, sizeof(out));
+        if (endStateRead(slot, sequence) && out.tick == tick) return true;
+    }
+}
+
+#endif // SHAREDSTATE_HPP
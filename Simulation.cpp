@@ -0,0 +1,690 @@
+#include "Simulation.h"
+#include "FixedKinematics.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "RoboticArm.h"
+#include "TaskPool.h"
+#include "TrigTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+std::vector<sf::CircleShape> items; // For future use if I want to add more Items
+bool itemGrabbed = false;
+sf::Vector2f grabbedItemOffset(0, 0);
+
+void drawItem(int x, int y) {
+    float radius = 5.0f;  // Set a visible size
+    sf::CircleShape item(radius);
+    item.setFillColor(sf::Color::Black);
+    item.setOutlineColor(sf::Color::Black);
+    item.setOutlineThickness(1.0f);
+    item.setPosition(x - radius, y - radius);  // Center the item
+
+
+    items.clear();
+    items.push_back(item); // Store the item so it persists
+}
+
+// Joint error (radians) below which a point-to-point move counts as finished
+constexpr float kSettleTolerance = 0.001f;
+
+// Allowed deviation of a Cartesian-linear move from its line (pixels). Fixed so
+// that a move re-planned from a recording matches the original exactly.
+constexpr float kLinearTolerance = 0.25f;
+
+// Arms stepped per pool task: stepArm is cheap, so a task must cover enough arms to pay for its scheduling
+constexpr size_t kArmsPerTask = 64;
+
+// Dynamics state of all arms in structure-of-arrays layout, reused from tick to tick
+static DynamicsBatch dynamicsBatch;
+
+static void printIkError(IkResult result) {
+    switch (result) {
+        case IkResult::Ok:
+            break;
+        case IkResult::OutOfReach:
+            logWarning("Target is out of reach!");
+            break;
+        case IkResult::InvalidTarget:
+            logWarning("Invalid target position");
+            break;
+        case IkResult::OutsideLimits:
+            logWarning("Target violates the joint limits!");
+            break;
+    }
+}
+
+/**
+ * Function to estimate how long the interpolation in stepArm takes to finish a move.
+ *
+ * Each tick closes smoothFactor of the remaining distance, so the largest joint
+ * error after n ticks is delta * (1 - smoothFactor)^n.
+ *
+ * @param delta The largest joint move (radians).
+ * @param smoothFactor The interpolation factor per tick.
+ * @return The number of ticks until every joint is within kSettleTolerance.
+ */
+float settleTicks(float delta, float smoothFactor) {
+    if (delta <= kSettleTolerance) return 0;
+    if (smoothFactor >= 1) return 1;
+    if (smoothFactor <= 0) return std::numeric_limits<float>::infinity();
+    return std::ceil(std::log(kSettleTolerance / delta) / std::log(1 - smoothFactor));
+}
+
+/**
+ * Function to calculate the target angles for the arm's current target.
+ *
+ * Chooses the configuration with the shortest joint-space move from the
+ * current pose, unwrapped so no joint sweeps the long way round, and skips
+ * configurations outside the joint limits. The target is left unchanged if
+ * neither configuration works. params.ikSolver picks the solver.
+ *
+ * @param arm The arm whose target angles are updated.
+ * @param params The simulation parameters (solver and move duration estimate).
+ * @return True if new target angles were set.
+ */
+static bool solveTarget(ArmState& arm, const SimulationParams& params) {
+    arm.tracking = false;
+    arm.linear = false;
+
+    float angle1 = arm.currentAngle1;
+    float angle2 = arm.currentAngle2;
+    bool elbowUp;
+    float moveTime;
+    ArmSolution up, down;
+    IkResult result = params.ikSolver == IkSolver::Cordic
+                          ? solveArmConfigurationsCordic(arm.px, arm.py, arm.tx, arm.ty, arm.L1, arm.L2, up, down)
+                          : solveArmConfigurations(arm.px, arm.py, arm.tx, arm.ty, arm.L1, arm.L2, up, down);
+    if (result == IkResult::Ok) {
+        result = chooseArmConfiguration(up, down, jointLimits(arm), angle1, angle2, elbowUp, moveTime);
+    }
+    countIkResult(result);
+    if (result != IkResult::Ok) {
+        printIkError(result);
+        return false;
+    }
+
+    float delta = std::max(std::abs(angle1 - arm.currentAngle1), std::abs(angle2 - arm.currentAngle2));
+    arm.moveTicks = settleTicks(delta, params.smoothFactor);
+    arm.targetAngle1 = angle1;
+    arm.targetAngle2 = angle2;
+    arm.elbowUp = elbowUp;
+    return true;
+}
+
+/**
+ * Function to apply a command to the arm.
+ *
+ * Commands arrive from the mouse, the console thread or other producers and are
+ * applied between ticks, so the loop never waits for input.
+ *
+ * @param arm The arm to update.
+ * @param command The command to apply.
+ * @param params The simulation parameters (grid size for grid-unit targets).
+ * @return none
+ */
+void applyCommand(ArmState& arm, const ArmCommand& command, const SimulationParams& params) {
+    float gridSize = params.gridSize;
+    switch (command.type) {
+        case ArmCommand::Type::TargetGrid: {
+            // Convert from grid units to pixel coordinates
+            arm.tx = arm.px + (command.a * gridSize); // Move left/right from center
+            arm.ty = arm.py - (command.b * gridSize); // Move up/down from center (negative Y because screen origin is top-left)
+
+            // Check if the new target is reachable
+            float d = std::sqrt((arm.tx - arm.px) * (arm.tx - arm.px) + (arm.ty - arm.py) * (arm.ty - arm.py));
+            if (d > arm.L1 + arm.L2) {
+                logWarning("Target is out of reach! Try again.");
+            } else {
+                logInfo("New target set at (", command.a, ", ", command.b, ") in grid coordinates");
+            }
+
+            // Calculate the new target angles
+            if (solveTarget(arm, params)) {
+                logDebug("Elbow-", arm.elbowUp ? "up" : "down", " move, about ", arm.moveTicks, " ticks");
+            }
+            break;
+        }
+
+        case ArmCommand::Type::Target: {
+            // Calculate the distance from the pivot point
+            float dx = command.a - arm.px;
+            float dy = command.b - arm.py;
+            float distance = std::sqrt(dx * dx + dy * dy);
+
+            // Check if the click is within the minimum reach circle
+            float minReach = std::max(0.0f, arm.L1 - arm.L2);
+            if (distance < minReach) {
+                // If it's inside the minimum reachable area, set the target at the minimum distance
+                float angle = std::atan2(dy, dx);
+                arm.tx = arm.px + minReach * std::cos(angle);
+                arm.ty = arm.py + minReach * std::sin(angle);
+            } else {
+                // Otherwise, set the target to the requested position
+                arm.tx = command.a;
+                arm.ty = command.b;
+            }
+
+            logInfo("New target set at (", (arm.tx - arm.px) / gridSize, ", ", -(arm.ty - arm.py) / gridSize, ") in grid coordinates");
+
+            // Calculate the new target angles
+            if (solveTarget(arm, params)) {
+                logDebug("Elbow-", arm.elbowUp ? "up" : "down", " move, about ", arm.moveTicks, " ticks");
+            }
+            break;
+        }
+
+        case ArmCommand::Type::Lengths:
+            // Ensure the lengths are valid
+            if (command.a <= 0 || command.b <= 0) {
+                logWarning("Lengths must be positive numbers!");
+                arm.L1 = 100; // Reset to default if invalid input
+                arm.L2 = 100;
+            } else {
+                arm.L1 = command.a;
+                arm.L2 = command.b;
+                logInfo("Updated lengths - L1: ", arm.L1, ", L2: ", arm.L2);
+            }
+            break;
+
+        case ArmCommand::Type::Pivot:
+            if (command.a < 0 || command.b < 0) {
+                logWarning("Zero point must be positive number!");
+                arm.px = 400; // Reset to default if invalid input
+                arm.py = 300;
+            } else {
+                arm.px = command.a;
+                arm.py = command.b;
+                logInfo("Updated zero point - Px: ", arm.px, ", Py: ", arm.py);
+            }
+            break;
+
+        case ArmCommand::Type::Item:
+            if (!params.updateItems) break;
+            if (itemGrabbed) {
+                static Counter& drops = metrics().counter("arm_item_drops_total", "Grabbed items dropped by placing a new item.");
+                drops.add();
+            }
+            itemGrabbed = false;
+            drawItem(static_cast<int>(command.a), static_cast<int>(command.b));
+            break;
+
+        case ArmCommand::Type::Track:
+            arm.linear = false;
+            arm.tracking = true;
+            arm.trackX = command.a;
+            arm.trackY = command.b;
+            break;
+
+        case ArmCommand::Type::Jog:
+            arm.linear = false;
+            if (!arm.tracking) {
+                // Start jogging from where the claw is now
+                ArmPose pose = computePose(arm);
+                arm.tracking = true;
+                arm.trackX = pose.x3;
+                arm.trackY = pose.y3;
+            }
+            arm.trackX += command.a;
+            arm.trackY += command.b;
+            break;
+
+        case ArmCommand::Type::Joints:
+            // Trajectories are planned within the limits; the arm takes the angles as given
+            arm.tracking = false;
+            arm.linear = false;
+            arm.currentAngle1 = arm.targetAngle1 = command.a;
+            arm.currentAngle2 = arm.targetAngle2 = command.b;
+            arm.elbowUp = std::sin(arm.currentAngle2) >= 0;
+            break;
+
+        case ArmCommand::Type::Linear: {
+            // Plan the whole line up front from where the claw is now, on the current elbow branch
+            ArmPose pose = computePose(arm);
+            bool elbowUp = std::sin(arm.currentAngle2) >= 0;
+            IkResult result = planLinearMove(arm.px, arm.py, arm.L1, arm.L2, jointLimits(arm), elbowUp,
+                                             arm.currentAngle1, arm.currentAngle2, pose.x3, pose.y3,
+                                             command.a, command.b, kLinearTolerance, arm.linearPlan);
+            if (result != IkResult::Ok) {
+                printIkError(result);
+                break;
+            }
+
+            arm.tracking = false;
+            arm.linear = true;
+            arm.linearX0 = pose.x3;
+            arm.linearY0 = pose.y3;
+            arm.linearS = 0;
+            arm.tx = command.a;
+            arm.ty = command.b;
+            arm.elbowUp = elbowUp;
+            logDebug("Linear move: ", arm.linearPlan.samples.size(), " IK samples (", arm.linearPlan.refined,
+                     " refined), max deviation ", arm.linearPlan.maxDeviation, " px");
+            break;
+        }
+    }
+}
+
+/**
+ * Function to create an arm from a scene record.
+ *
+ * The arm starts at rest with its target at the pivot.
+ *
+ * @param record The arm as stored in the scene file.
+ * @return The arm state.
+ */
+ArmState armFromScene(const SceneArm& record) {
+    ArmState arm;
+    arm.px = arm.tx = record.px;
+    arm.py = arm.ty = record.py;
+    arm.L1 = record.L1;
+    arm.L2 = record.L2;
+    arm.minAngle1 = record.minAngle1;
+    arm.maxAngle1 = record.maxAngle1;
+    arm.minAngle2 = record.minAngle2;
+    arm.maxAngle2 = record.maxAngle2;
+    return arm;
+}
+
+bool withinJointLimits(const ArmState& arm, float angle1, float angle2) {
+    return angle1 >= arm.minAngle1 && angle1 <= arm.maxAngle1 && angle2 >= arm.minAngle2 && angle2 <= arm.maxAngle2;
+}
+
+JointLimits jointLimits(const ArmState& arm) {
+    JointLimits limits;
+    limits.min1 = arm.minAngle1;
+    limits.max1 = arm.maxAngle1;
+    limits.min2 = arm.minAngle2;
+    limits.max2 = arm.maxAngle2;
+    limits.speed1 = arm.speed1;
+    limits.speed2 = arm.speed2;
+    return limits;
+}
+
+/**
+ * Function to move the arm one tick.
+ *
+ * In target mode the joint angles are interpolated towards the target angles.
+ * In a Cartesian-linear move the claw advances params.trackSpeed pixels along
+ * the line, reading the joint angles off the pre-solved plan. In tracking mode
+ * the end effector moves straight towards the tracked point at no more than
+ * params.trackSpeed pixels per tick, using resolved-rate control, so dragging
+ * and jogging never trigger a full IK re-solve.
+ *
+ * @param arm The arm to move.
+ * @param params The simulation parameters.
+ * @return none
+ */
+void stepArm(ArmState& arm, const SimulationParams& params) {
+    if (arm.linear) {
+        float length = arm.linearPlan.samples.back().s;
+        arm.linearS = std::min(arm.linearS + params.trackSpeed, length);
+        ArmSolution angles = sampleLinearMove(arm.linearPlan, arm.linearS);
+        arm.currentAngle1 = arm.targetAngle1 = angles.angle1;
+        arm.currentAngle2 = arm.targetAngle2 = angles.angle2;
+        if (arm.linearS >= length) {
+            arm.linear = false;
+            static Counter& completed = metrics().counter("arm_trajectories_completed_total{kind=\"linear\"}",
+                                                          "Trajectories that ran to their end, by kind.");
+            completed.add();
+        }
+        return;
+    }
+
+    if (!arm.tracking) {
+        // Smoothly interpolate angles towards the target angles
+        arm.currentAngle1 = lerp(arm.currentAngle1, arm.targetAngle1, params.smoothFactor);
+        arm.currentAngle2 = lerp(arm.currentAngle2, arm.targetAngle2, params.smoothFactor);
+        return;
+    }
+
+    ArmPose pose = computePose(arm);
+    float vx = arm.trackX - pose.x3;
+    float vy = arm.trackY - pose.y3;
+    float distance = std::sqrt(vx * vx + vy * vy);
+    if (distance > params.trackSpeed) {
+        vx *= params.trackSpeed / distance;
+        vy *= params.trackSpeed / distance;
+    }
+
+    float dAngle1, dAngle2;
+    resolvedRateStep(arm.L1, arm.L2, arm.currentAngle1, arm.currentAngle2, vx, vy, dAngle1, dAngle2);
+    arm.currentAngle1 = std::clamp(arm.currentAngle1 + dAngle1, arm.minAngle1, arm.maxAngle1);
+    arm.currentAngle2 = std::clamp(arm.currentAngle2 + dAngle2, arm.minAngle2, arm.maxAngle2);
+
+    // Keep the target at the current pose so leaving tracking mode does not jump
+    arm.targetAngle1 = arm.currentAngle1;
+    arm.targetAngle2 = arm.currentAngle2;
+    arm.elbowUp = std::sin(arm.currentAngle2) >= 0; // angle2 may be unwrapped past +-pi
+}
+
+/**
+ * Function to compute the joint positions from the current angles.
+ *
+ * @param arm The arm state.
+ * @param trig The sine/cosine to use; FkTrig::Table for poses that are only drawn or checked for contact.
+ * @return The elbow and end effector positions.
+ */
+ArmPose computePose(const ArmState& arm, FkTrig trig) {
+    ArmPose pose;
+    if (trig == FkTrig::Table) {
+        float s1, c1, s12, c12;
+        tableSinCos(arm.currentAngle1, s1, c1);
+        tableSinCos(arm.currentAngle1 + arm.currentAngle2, s12, c12);
+        pose.x2 = arm.px + arm.L1 * c1;
+        pose.y2 = arm.py + arm.L1 * s1;
+        pose.x3 = pose.x2 + arm.L2 * c12;
+        pose.y3 = pose.y2 + arm.L2 * s12;
+        return pose;
+    }
+    forwardKinematics(arm.px, arm.py, arm.L1, arm.L2, arm.currentAngle1, arm.currentAngle2,
+                      pose.x2, pose.y2, pose.x3, pose.y3);
+    return pose;
+}
+
+/**
+ * Function to grab the item when the claw reaches it and carry it along.
+ *
+ * @param arm The arm state.
+ * @param pose The current joint positions of the arm.
+ * @param params The simulation parameters (claw length and grab distance).
+ * @return none
+ */
+void updateGrab(const ArmState& arm, const ArmPose& pose, const SimulationParams& params) {
+    if (items.empty()) return;
+
+    sf::Vector2f itemPos = items[0].getPosition();
+    float itemX = itemPos.x + items[0].getRadius();
+    float itemY = itemPos.y + items[0].getRadius();
+    float distToClaw = std::sqrt((itemX - pose.x3) * (itemX - pose.x3) + (itemY - pose.y3) * (itemY - pose.y3));
+
+    if (distToClaw < params.grabDistance) {
+        if (!itemGrabbed) {
+            static Counter& grabs = metrics().counter("arm_item_grabs_total", "Items grabbed by the claw.");
+            grabs.add();
+            itemGrabbed = true;
+            grabbedItemOffset.x = itemX - pose.x3;
+            grabbedItemOffset.y = itemY - pose.y3;
+        }
+    }
+
+    if (itemGrabbed) {
+        // Offset the item forward so it's not directly above the claw
+        float offsetDistance = params.clawLength * 1.0f; // Move item slightly forward
+        float clawTipX = pose.x3 + offsetDistance * std::cos(arm.currentAngle1 + arm.currentAngle2);
+        float clawTipY = pose.y3 + offsetDistance * std::sin(arm.currentAngle1 + arm.currentAngle2);
+
+        items[0].setPosition(clawTipX - items[0].getRadius(), clawTipY - items[0].getRadius());
+    }
+}
+
+/**
+ * Function to advance the simulation by one tick.
+ *
+ * Applies the tick's commands, moves the arm towards its target angles and
+ * updates the grabbed item. Depends only on its inputs, so replaying the
+ * recorded commands reproduces a session.
+ *
+ * @param arm The arm to advance.
+ * @param commands The commands applied at the start of this tick.
+ * @param params The simulation parameters.
+ * @return none
+ */
+void tickSimulation(ArmState& arm, const std::vector<ArmCommand>& commands, const SimulationParams& params) {
+    for (const ArmCommand& command : commands) {
+        applyCommand(arm, command, params);
+    }
+
+    stepArm(arm, params);
+    if (params.updateItems) updateGrab(arm, computePose(arm, params.fkTrig), params);
+}
+
+// Steps arms[1..] kinematically, in chunks on the pool when there are enough of them
+static void stepOtherArms(std::vector<ArmState>& arms, const SimulationParams& params, TaskPool* pool) {
+    if (!pool || arms.size() <= kArmsPerTask) {
+        for (size_t i = 1; i < arms.size(); ++i) {
+            stepArm(arms[i], params);
+        }
+        return;
+    }
+
+    size_t chunks = (arms.size() - 1 + kArmsPerTask - 1) / kArmsPerTask;
+    pool->parallelFor(chunks, [&](size_t chunk) {
+        size_t end = std::min(arms.size(), 1 + (chunk + 1) * kArmsPerTask);
+        for (size_t i = 1 + chunk * kArmsPerTask; i < end; ++i) {
+            stepArm(arms[i], params);
+        }
+    });
+}
+
+// Saves the joint state of every arm in the batch and swaps in its reference, so the
+// tick's commands and kinematic step advance the reference instead of the joints
+static void beginDynamicsTick(std::vector<ArmState>& arms, const SimulationParams& params) {
+    const DynamicsParams& dynamics = params.dynamicsParams;
+    dynamicsBatch.resize(arms.size());
+    for (size_t i = 0; i < arms.size(); ++i) {
+        ArmState& arm = arms[i];
+        if (!arm.referenceValid) {
+            arm.referenceAngle1 = arm.currentAngle1;
+            arm.referenceAngle2 = arm.currentAngle2;
+            arm.referenceVelocity1 = arm.referenceVelocity2 = 0;
+            arm.velocity1 = arm.velocity2 = 0;
+            arm.integral1 = arm.integral2 = 0;
+            arm.referenceValid = true;
+        }
+        dynamicsBatch.L1[i] = arm.L1 * dynamics.metersPerPixel;
+        dynamicsBatch.L2[i] = arm.L2 * dynamics.metersPerPixel;
+        dynamicsBatch.maxTorque1[i] = dynamics.defaultMaxTorque1;
+        dynamicsBatch.maxTorque2[i] = dynamics.defaultMaxTorque2;
+        dynamicsBatch.angle1[i] = arm.currentAngle1;
+        dynamicsBatch.angle2[i] = arm.currentAngle2;
+        dynamicsBatch.velocity1[i] = arm.velocity1;
+        dynamicsBatch.velocity2[i] = arm.velocity2;
+        dynamicsBatch.integral1[i] = arm.integral1;
+        dynamicsBatch.integral2[i] = arm.integral2;
+        arm.currentAngle1 = arm.referenceAngle1;
+        arm.currentAngle2 = arm.referenceAngle2;
+    }
+}
+
+// Servos every arm towards its advanced reference and integrates one tick of dynamics
+static void finishDynamicsTick(std::vector<ArmState>& arms, const SimulationParams& params, TaskPool* pool) {
+    float dt = params.dynamicsParams.dt;
+    for (size_t i = 0; i < arms.size(); ++i) {
+        ArmState& arm = arms[i];
+        float velocity1 = (arm.currentAngle1 - arm.referenceAngle1) / dt;
+        float velocity2 = (arm.currentAngle2 - arm.referenceAngle2) / dt;
+        dynamicsBatch.setpoint1[i] = arm.currentAngle1;
+        dynamicsBatch.setpoint2[i] = arm.currentAngle2;
+        dynamicsBatch.setpointVelocity1[i] = velocity1;
+        dynamicsBatch.setpointVelocity2[i] = velocity2;
+        dynamicsBatch.setpointAcceleration1[i] = (velocity1 - arm.referenceVelocity1) / dt;
+        dynamicsBatch.setpointAcceleration2[i] = (velocity2 - arm.referenceVelocity2) / dt;
+        arm.referenceVelocity1 = velocity1;
+        arm.referenceVelocity2 = velocity2;
+    }
+
+    auto step = [&](size_t begin, size_t end) {
+        servoTorques(dynamicsBatch, params.dynamicsParams, begin, end);
+        stepDynamics(dynamicsBatch, params.dynamicsParams, begin, end);
+    };
+    if (!pool || arms.size() <= kArmsPerTask) {
+        step(0, arms.size());
+    } else {
+        size_t chunks = (arms.size() + kArmsPerTask - 1) / kArmsPerTask;
+        pool->parallelFor(chunks, [&](size_t chunk) {
+            step(chunk * kArmsPerTask, std::min(arms.size(), (chunk + 1) * kArmsPerTask));
+        });
+    }
+
+    for (size_t i = 0; i < arms.size(); ++i) {
+        ArmState& arm = arms[i];
+        arm.referenceAngle1 = arm.currentAngle1;
+        arm.referenceAngle2 = arm.currentAngle2;
+        arm.currentAngle1 = dynamicsBatch.angle1[i];
+        arm.currentAngle2 = dynamicsBatch.angle2[i];
+        arm.velocity1 = dynamicsBatch.velocity1[i];
+        arm.velocity2 = dynamicsBatch.velocity2[i];
+        arm.torque1 = dynamicsBatch.torque1[i];
+        arm.torque2 = dynamicsBatch.torque2[i];
+        arm.integral1 = dynamicsBatch.integral1[i];
+        arm.integral2 = dynamicsBatch.integral2[i];
+    }
+}
+
+/**
+ * Function to advance every arm by one tick.
+ *
+ * The interactive arm (arms[0]) receives the tick's commands and can grab the
+ * item; the other arms move towards their own targets. With a task pool the
+ * other arms are stepped in fixed chunks of kArmsPerTask, chunk c preferring
+ * worker c, so each arm stays on one worker from tick to tick.
+ *
+ * In dynamics mode the commands and the kinematic step move each arm's
+ * reference pose; the joint servo (params.dynamicsParams.law) then drives
+ * the joints after it through the rigid-body dynamics, all arms as one batch,
+ * params.dynamicsParams.dt per tick. Arms with weak motors or fast moves
+ * visibly lag their reference.
+ *
+ * @param arms The arms to advance.
+ * @param commands The commands applied to arms[0] at the start of this tick.
+ * @param params The simulation parameters.
+ * @param pool The task pool, or nullptr to step every arm on the calling thread.
+ * @return none
+ */
+void tickArms(std::vector<ArmState>& arms, const std::vector<ArmCommand>& commands, const SimulationParams& params,
+              TaskPool* pool) {
+    if (!params.dynamics) {
+        tickSimulation(arms[0], commands, params);
+        stepOtherArms(arms, params, pool);
+        return;
+    }
+
+    beginDynamicsTick(arms, params);
+    for (const ArmCommand& command : commands) {
+        applyCommand(arms[0], command, params);
+    }
+    stepArm(arms[0], params);
+    stepOtherArms(arms, params, pool);
+    finishDynamicsTick(arms, params, pool);
+    if (params.updateItems) updateGrab(arms[0], computePose(arms[0], params.fkTrig), params);
+}
+
+void retargetArm(ArmState& arm, float tx, float ty, const SimulationParams& params) {
+    arm.tx = tx;
+    arm.ty = ty;
+    solveTarget(arm, params);
+}
+
+/**
+ * Function to capture the arm and item state into a telemetry frame.
+ *
+ * Fills every field except the tick and the commands, reusing the frame's
+ * storage so recording does not allocate in steady state.
+ *
+ * @param arm The arm state.
+ * @param frame The frame to fill (output).
+ * @return none
+ */
+void captureTelemetry(const ArmState& arm, TelemetryFrame& frame) {
+    frame.fields[0] = arm.currentAngle1;
+    frame.fields[1] = arm.currentAngle2;
+    frame.fields[2] = arm.targetAngle1;
+    frame.fields[3] = arm.targetAngle2;
+    frame.fields[4] = arm.tx;
+    frame.fields[5] = arm.ty;
+    frame.fields[6] = arm.px;
+    frame.fields[7] = arm.py;
+    frame.fields[8] = arm.L1;
+    frame.fields[9] = arm.L2;
+    frame.fields[10] = arm.trackX;
+    frame.fields[11] = arm.trackY;
+    frame.fields[12] = arm.linearX0;
+    frame.fields[13] = arm.linearY0;
+    frame.fields[14] = arm.linearS;
+    frame.elbowUp = arm.elbowUp;
+    frame.tracking = arm.tracking;
+    frame.linear = arm.linear;
+    frame.itemGrabbed = itemGrabbed;
+
+    frame.items.resize(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        sf::Vector2f position = items[i].getPosition();
+        frame.items[i].x = position.x + items[i].getRadius();
+        frame.items[i].y = position.y + items[i].getRadius();
+    }
+}
+
+/**
+ * Function to rebuild the plan of a Cartesian-linear move after a restore.
+ *
+ * Planning is deterministic in the line, the elbow branch and the tolerance,
+ * so the samples come out identical to the original plan up to a whole number
+ * of turns per joint, which is recovered from the restored angles.
+ *
+ * @param arm The restored arm, in the middle of a linear move.
+ * @return none
+ */
+static void restoreLinearMove(ArmState& arm) {
+    // No position limits here: the original plan already respected them, and
+    // limits could otherwise shift the unwrapping of the first sample
+    IkResult result = planLinearMove(arm.px, arm.py, arm.L1, arm.L2, JointLimits(), arm.elbowUp,
+                                     arm.currentAngle1, arm.currentAngle2, arm.linearX0, arm.linearY0,
+                                     arm.tx, arm.ty, kLinearTolerance, arm.linearPlan);
+    if (result != IkResult::Ok) {
+        arm.linear = false;
+        return;
+    }
+
+    const float twoPi = 6.28318531f;
+    ArmSolution planned = sampleLinearMove(arm.linearPlan, arm.linearS);
+    float turns1 = std::round((arm.currentAngle1 - planned.angle1) / twoPi) * twoPi;
+    float turns2 = std::round((arm.currentAngle2 - planned.angle2) / twoPi) * twoPi;
+    for (LinearSample& sample : arm.linearPlan.samples) {
+        sample.angles.angle1 += turns1;
+        sample.angles.angle2 += turns2;
+    }
+}
+
+/**
+ * Function to restore the arm and item state from a telemetry frame.
+ *
+ * Restoring from a keyframe is exact; delta frames carry quantized values.
+ *
+ * @param frame The recorded frame.
+ * @param arm The arm state to overwrite (output).
+ * @return none
+ */
+void restoreTelemetry(const TelemetryFrame& frame, ArmState& arm) {
+    arm.currentAngle1 = frame.fields[0];
+    arm.currentAngle2 = frame.fields[1];
+    arm.targetAngle1 = frame.fields[2];
+    arm.targetAngle2 = frame.fields[3];
+    arm.tx = frame.fields[4];
+    arm.ty = frame.fields[5];
+    arm.px = frame.fields[6];
+    arm.py = frame.fields[7];
+    arm.L1 = frame.fields[8];
+    arm.L2 = frame.fields[9];
+    arm.trackX = frame.fields[10];
+    arm.trackY = frame.fields[11];
+    arm.linearX0 = frame.fields[12];
+    arm.linearY0 = frame.fields[13];
+    arm.linearS = frame.fields[14];
+    arm.elbowUp = frame.elbowUp;
+    arm.tracking = frame.tracking;
+    arm.linear = frame.linear;
+    if (arm.linear) restoreLinearMove(arm);
+    itemGrabbed = frame.itemGrabbed;
+
+    // drawItem() replaces the item list, so build the shapes one at a time
+    std::vector<sf::CircleShape> restored;
+    for (const TelemetryItem& item : frame.items) {
+        drawItem(0, 0);
+        items.back().setPosition(item.x - items.back().getRadius(), item.y - items.back().getRadius());
+        restored.push_back(items.back());
+    }
+    items = restored;
+}
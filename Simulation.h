@@ -0,0 +1,134 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <SFML/Graphics.hpp>
+#include <limits>
+#include <vector>
+#include "Command.h"
+#include "Dynamics.h"
+#include "LinearMove.h"
+#include "SceneFormat.h"
+#include "Telemetry.h"
+
+class TaskPool;
+
+// Items placed in the scene by the operator
+extern std::vector<sf::CircleShape> items;
+extern bool itemGrabbed;
+extern sf::Vector2f grabbedItemOffset;
+
+// Inverse kinematics solver for new targets
+enum class IkSolver {
+    Float, // solveArmConfigurations in float
+    Cordic // The arm controllers' fixed-point CORDIC solver (FixedKinematics.h)
+};
+
+// Sine/cosine of the per-tick poses that are drawn and checked for contact
+enum class FkTrig {
+    Std,  // std::sin/std::cos
+    Table // Interpolated lookup table, error <= 3.4e-6 * (L1 + L2) px (TrigTable.h)
+};
+
+// Parameters shared by the live loop, headless replay and the benchmarks
+struct SimulationParams {
+    float gridSize = 10;         // Grid size for visualization
+    float smoothFactor = 0.001f; // Factor for smooth movement
+    float clawLength = 10.0f;    // Length of the claw fingers
+    float grabDistance = 10.0f;
+    float trackSpeed = 0.5f;     // Max end-effector speed while dragging or jogging (pixels per tick)
+    float thickness = 4.0f;      // Thickness of the arm
+    float clawWidth = 2.5f;      // Width of the claw fingers
+    bool dynamics = false;       // Joints follow the kinematic motion under motor torque instead of exactly
+    bool updateItems = true;     // Place and carry the item; off where another thread owns the item list
+    IkSolver ikSolver = IkSolver::Float;
+    FkTrig fkTrig = FkTrig::Std; // Control and planning always use std::sin/std::cos
+    DynamicsParams dynamicsParams;
+};
+
+// State of one two-link arm
+struct ArmState {
+    float px = 400, py = 300; // Pivot point
+    float L1 = 100, L2 = 100; // Length of the arm segments
+
+    float tx = 400, ty = 300; // Target point
+
+    float targetAngle1 = 0, targetAngle2 = 0; // Target arm angles
+    float currentAngle1 = 0, currentAngle2 = 0; // Current animated arm angles
+
+    bool elbowUp = false;
+
+    // Cartesian tracking: follow (trackX, trackY) with resolved-rate control instead of lerping
+    bool tracking = false;
+    float trackX = 0, trackY = 0;
+
+    // Cartesian-linear move from (linearX0, linearY0) to (tx, ty); linearS is the distance covered so far
+    bool linear = false;
+    float linearX0 = 0, linearY0 = 0;
+    float linearS = 0;
+    LinearPlan linearPlan;
+
+    // Joint limits (radians); unlimited unless the scene sets them
+    float minAngle1 = -std::numeric_limits<float>::infinity();
+    float maxAngle1 = std::numeric_limits<float>::infinity();
+    float minAngle2 = -std::numeric_limits<float>::infinity();
+    float maxAngle2 = std::numeric_limits<float>::infinity();
+    float speed1 = 1, speed2 = 1; // Relative joint speeds, weigh the move time when choosing a configuration
+
+    float moveTicks = 0; // Estimated duration of the current point-to-point move
+
+    // Dynamics mode: the kinematic motion moves the reference, and the current angles follow it under torque
+    bool referenceValid = false;
+    float referenceAngle1 = 0, referenceAngle2 = 0;
+    float referenceVelocity1 = 0, referenceVelocity2 = 0; // Rate of the reference over the last tick (rad/s)
+    float velocity1 = 0, velocity2 = 0; // Joint velocities (rad/s)
+    float torque1 = 0, torque2 = 0;     // Motor torques of the last tick (N m)
+    float integral1 = 0, integral2 = 0; // Integrated joint error of the Pid law (rad s)
+};
+
+// Joint positions of an arm
+struct ArmPose {
+    float x2, y2; // Elbow
+    float x3, y3; // End effector
+};
+
+// Function to apply a command to the arm at a tick boundary
+void applyCommand(ArmState& arm, const ArmCommand& command, const SimulationParams& params);
+
+// Function to create an arm from a scene record
+ArmState armFromScene(const SceneArm& record);
+
+// Function to check whether joint angles are within the arm's limits
+bool withinJointLimits(const ArmState& arm, float angle1, float angle2);
+
+// Function to collect the arm's joint limits and speeds for configuration selection
+JointLimits jointLimits(const ArmState& arm);
+
+// Function to move the arm one tick towards its target angles or tracked point
+void stepArm(ArmState& arm, const SimulationParams& params);
+
+// Function to estimate how many ticks stepArm takes to finish a point-to-point move
+float settleTicks(float delta, float smoothFactor);
+
+// Function to compute the joint positions from the current angles
+ArmPose computePose(const ArmState& arm, FkTrig trig = FkTrig::Std);
+
+// Function to grab the item when the claw reaches it and carry it along
+void updateGrab(const ArmState& arm, const ArmPose& pose, const SimulationParams& params);
+
+// Function to advance the simulation by one tick
+void tickSimulation(ArmState& arm, const std::vector<ArmCommand>& commands, const SimulationParams& params);
+
+// Function to advance every arm by one tick; commands go to the interactive arm (arms[0])
+void tickArms(std::vector<ArmState>& arms, const std::vector<ArmCommand>& commands, const SimulationParams& params,
+              TaskPool* pool = nullptr);
+
+// Function to set a new target point and solve for its angles
+void retargetArm(ArmState& arm, float tx, float ty, const SimulationParams& params);
+
+// Function to capture the arm and item state into a telemetry frame
+void captureTelemetry(const ArmState& arm, TelemetryFrame& frame);
+
+// Function to restore the arm and item state from a telemetry frame
+void restoreTelemetry(const TelemetryFrame& frame, ArmState& arm);
+
+#endif // SIMULATION_HPP
@@ -0,0 +1,111 @@
+#include "StatePublisher.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+StatePublisher::~StatePublisher() {
+    close();
+}
+
+/**
+ * Function to create and map the shared-memory state ring.
+ *
+ * @param name The POSIX shared-memory object name (e.g. "/robotic_arm_state").
+ * @return true if the ring is mapped and ready.
+ */
+bool StatePublisher::open(const std::string& name) {
+    close();
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        logError("Failed to open shared memory ", name, ": ", std::strerror(errno));
+        return false;
+    }
+    if (::ftruncate(fd, sizeof(SharedStateHeader)) < 0) {
+        logError("Failed to size shared memory ", name, ": ", std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    void* memory = ::mmap(nullptr, sizeof(SharedStateHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        logError("Failed to map shared memory ", name, ": ", std::strerror(errno));
+        return false;
+    }
+
+    // Readers check the magic last, so publish it after everything else is initialized
+    header = new (memory) SharedStateHeader;
+    header->version = kStateVersion;
+    header->slotCount = kStateSlots;
+    header->frameSize = sizeof(SharedArmFrame);
+    header->latestTick.store(~0ull, std::memory_order_relaxed);
+    for (SharedStateSlot& slot : header->slots) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = kStateMagic;
+
+    shmName = name;
+    tick = 0;
+    logInfo("Publishing arm state to shared memory ", name);
+    return true;
+}
+
+void StatePublisher::close() {
+    if (!header) return;
+    ::munmap(header, sizeof(SharedStateHeader));
+    ::shm_unlink(shmName.c_str());
+    header = nullptr;
+}
+
+/**
+ * Function to publish one tick of arm state.
+ *
+ * Writes the frame in place into the next ring slot under its seqlock. Items
+ * beyond kMaxPublishedItems are not published.
+ *
+ * @param arm The arm state.
+ * @param x2 The x-coordinate of the elbow joint.
+ * @param y2 The y-coordinate of the elbow joint.
+ * @param x3 The x-coordinate of the end effector.
+ * @param y3 The y-coordinate of the end effector.
+ * @return none
+ */
+void StatePublisher::publish(const ArmState& arm, float x2, float y2, float x3, float y3) {
+    if (!header) return;
+
+    SharedStateSlot& slot = header->slots[tick % kStateSlots];
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    SharedArmFrame& frame = slot.frame;
+    frame.tick = tick;
+    frame.angle1 = arm.currentAngle1;
+    frame.angle2 = arm.currentAngle2;
+    frame.x2 = x2;
+    frame.y2 = y2;
+    frame.x3 = x3;
+    frame.y3 = y3;
+    frame.itemGrabbed = itemGrabbed ? 1u : 0u;
+
+    uint32_t count = 0;
+    for (const auto& item : items) {
+        if (count == kMaxPublishedItems) break;
+        sf::Vector2f position = item.getPosition();
+        frame.items[count].x = position.x + item.getRadius();
+        frame.items[count].y = position.y + item.getRadius();
+        ++count;
+    }
+    frame.itemCount = count;
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    header->latestTick.store(tick, std::memory_order_release);
+    ++tick;
+}
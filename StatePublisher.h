@@ -0,0 +1,35 @@
+#ifndef STATEPUBLISHER_HPP
+#define STATEPUBLISHER_HPP
+
+#include <string>
+#include "SharedState.h"
+#include "Simulation.h"
+
+/**
+ * Publishes the arm state to a POSIX shared-memory ring every tick.
+ *
+ * The frame is written directly into the mapped slot, so publishing costs one
+ * small memcpy-sized write and two atomic stores; readers in other processes
+ * consume it with the seqlock helpers in SharedState.h.
+ */
+class StatePublisher {
+public:
+    StatePublisher() = default;
+    ~StatePublisher();
+
+    StatePublisher(const StatePublisher&) = delete;
+    StatePublisher& operator=(const StatePublisher&) = delete;
+
+    bool open(const std::string& name);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    void publish(const ArmState& arm, float x2, float y2, float x3, float y3);
+
+private:
+    std::string shmName;
+    SharedStateHeader* header = nullptr;
+    uint64_t tick = 0;
+};
+
+#endif // STATEPUBLISHER_HPP
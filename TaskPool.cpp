@@ -0,0 +1,217 @@
+#include "TaskPool.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+TaskPool::~TaskPool() {
+    stop();
+}
+
+/**
+ * Function to start the worker threads.
+ *
+ * @param workers The number of workers, including the thread calling wait().
+ * @return none
+ */
+void TaskPool::start(unsigned workers) {
+    stop();
+
+    workers = std::max(1u, workers);
+    for (unsigned i = 0; i < workers; ++i) {
+        this->workers.push_back(std::make_unique<Worker>());
+    }
+    stopping = false;
+    for (unsigned i = 1; i < workers; ++i) {
+        this->workers[i]->thread = std::thread(&TaskPool::workerLoop, this, static_cast<size_t>(i));
+    }
+    resetStats();
+    lastReportNs = statsStartNs;
+}
+
+/**
+ * Function to stop the worker threads once the queued tasks have run.
+ *
+ * @return none
+ */
+void TaskPool::stop() {
+    if (workers.empty()) return;
+
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 1; i < workers.size(); ++i) {
+        workers[i]->thread.join();
+    }
+    workers.clear();
+}
+
+/**
+ * Function to queue a task.
+ *
+ * Without started workers the task runs immediately on the calling thread.
+ *
+ * @param worker The preferred worker, taken modulo the worker count.
+ * @param task The task.
+ * @return none
+ */
+void TaskPool::submit(size_t worker, std::function<void()> task) {
+    if (workers.empty()) {
+        task();
+        return;
+    }
+
+    pending.fetch_add(1, std::memory_order_relaxed);
+    Worker& owner = *workers[worker % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(owner.mutex);
+        owner.tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    if (workers.size() > 1) {
+        // Taking the lock orders this wake-up after a sleeper's last look at `queued`
+        { std::lock_guard<std::mutex> lock(wakeMutex); }
+        wake.notify_one();
+    }
+}
+
+/**
+ * Function to wait for all queued tasks.
+ *
+ * The calling thread runs tasks as worker 0 meanwhile: its own first, then
+ * stolen ones.
+ *
+ * @return none
+ */
+void TaskPool::wait() {
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!runOne(0)) std::this_thread::yield();
+    }
+}
+
+/**
+ * Function to run an indexed loop on the pool.
+ *
+ * Index i is queued on worker i % workerCount(), so a loop over the same data
+ * every tick keeps each part on the same worker unless it is stolen.
+ *
+ * @param count The number of indices.
+ * @param task The loop body, called once per index.
+ * @return none
+ */
+void TaskPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+    if (workers.size() <= 1 || count <= 1) {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        submit(i, [&task, i] { task(i); });
+    }
+    wait();
+}
+
+const std::vector<TaskWorkerStats>& TaskPool::stats() {
+    snapshot.clear();
+    for (const std::unique_ptr<Worker>& worker : workers) snapshot.push_back(worker->stats);
+    return snapshot;
+}
+
+void TaskPool::resetStats() {
+    for (std::unique_ptr<Worker>& worker : workers) worker->stats = TaskWorkerStats();
+    statsStartNs = nowNs();
+}
+
+/**
+ * Function to print per-worker utilization and steal counts.
+ *
+ * Utilization is the time spent inside tasks over the wall time since the last
+ * report. Statistics are reset after printing.
+ *
+ * @param intervalSeconds Minimum time between two reports.
+ * @return none
+ */
+void TaskPool::reportStats(double intervalSeconds) {
+    uint64_t now = nowNs();
+    if (workers.empty() || static_cast<double>(now - lastReportNs) < intervalSeconds * 1e9) return;
+    lastReportNs = now;
+
+    uint64_t tasks = 0;
+    for (const std::unique_ptr<Worker>& worker : workers) tasks += worker->stats.tasks;
+    if (tasks == 0) {
+        // Nothing ran on the pool (e.g. a single arm); stay quiet
+        resetStats();
+        return;
+    }
+
+    double wallNs = static_cast<double>(std::max<uint64_t>(1, now - statsStartNs));
+    std::ostringstream report; // One message, so the per-message rate limit never cuts the worker lines
+    report << "Task pool: " << workers.size() << " workers\n";
+    for (size_t i = 0; i < workers.size(); ++i) {
+        const TaskWorkerStats& stats = workers[i]->stats;
+        report << "  worker " << i << ": " << 100.0 * static_cast<double>(stats.busyNs) / wallNs << "% busy, "
+               << stats.tasks << " tasks (" << stats.stolen << " stolen)\n";
+    }
+    logInfo(report.str());
+    resetStats();
+}
+
+void TaskPool::workerLoop(size_t index) {
+    while (true) {
+        if (runOne(index)) continue;
+
+        // Spin briefly: the next tick's tasks usually arrive within microseconds
+        for (int round = 0; round < kSpinRounds && queued.load(std::memory_order_acquire) == 0; ++round) {
+            std::this_thread::yield();
+        }
+        if (queued.load(std::memory_order_acquire) > 0) continue;
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+// Runs the newest task of the worker's own deque, or else the oldest task of another worker
+bool TaskPool::runOne(size_t index) {
+    std::function<void()> task;
+    bool stolen = false;
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    for (size_t k = 1; !task && k < workers.size(); ++k) {
+        Worker& victim = *workers[(index + k) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            stolen = true;
+        }
+    }
+    if (!task) return false;
+    queued.fetch_sub(1, std::memory_order_relaxed);
+
+    uint64_t start = nowNs();
+    task();
+    TaskWorkerStats& stats = workers[index]->stats;
+    stats.busyNs += nowNs() - start;
+    ++stats.tasks;
+    if (stolen) ++stats.stolen;
+
+    pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+uint64_t TaskPool::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,85 @@
+#ifndef TASKPOOL_HPP
+#define TASKPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct TaskWorkerStats {
+    uint64_t tasks = 0;  // Tasks run by this worker
+    uint64_t stolen = 0; // Of those, tasks taken from another worker's deque
+    uint64_t busyNs = 0; // Time spent inside tasks
+};
+
+/**
+ * Work-stealing task pool for the simulation tick.
+ *
+ * Every worker owns a deque. Tasks are submitted to a preferred worker, which
+ * runs them newest first so the data it just touched stays in its cache; an
+ * idle worker steals the oldest task of the next busy worker. The thread that
+ * calls wait() takes part as worker 0, so a pool of N workers starts N - 1
+ * threads, and a pool of one worker runs everything inline.
+ *
+ * Submitting tasks and wait() belong to one thread (the simulation loop);
+ * tasks may submit further tasks. Statistics are only read between wait()s.
+ */
+class TaskPool {
+public:
+    TaskPool() = default;
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    void start(unsigned workers);
+    void stop();
+    unsigned workerCount() const { return static_cast<unsigned>(workers.size()); }
+
+    // Queue a task on a worker (taken modulo the worker count)
+    void submit(size_t worker, std::function<void()> task);
+
+    // Run queued tasks on the calling thread too, until every task has finished
+    void wait();
+
+    // Run task(i) for i in [0, count), index i preferring worker i % workerCount()
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    const std::vector<TaskWorkerStats>& stats();
+    void resetStats();
+
+    // Print per-worker utilization at most once per interval (wall-clock seconds)
+    void reportStats(double intervalSeconds);
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        TaskWorkerStats stats;
+        std::thread thread;
+    };
+
+    void workerLoop(size_t index);
+    bool runOne(size_t index);
+
+    static uint64_t nowNs();
+
+    static constexpr int kSpinRounds = 200; // Steal attempts before an idle worker sleeps
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<TaskWorkerStats> snapshot;
+    std::atomic<size_t> queued{0};  // Tasks in the deques
+    std::atomic<size_t> pending{0}; // Tasks queued or running
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    uint64_t statsStartNs = 0;
+    uint64_t lastReportNs = 0;
+};
+
+#endif // TASKPOOL_HPP
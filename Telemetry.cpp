@@ -0,0 +1,248 @@
+#include "Telemetry.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void putSigned(std::vector<uint8_t>& out, int64_t value) {
+    // Zigzag so small negative deltas stay small
+    putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+template <typename T>
+void putRaw(std::vector<uint8_t>& out, T value) {
+    size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+struct Reader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= size) break;
+            uint8_t byte = data[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    int64_t signedVarint() {
+        uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    template <typename T>
+    T raw() {
+        T value{};
+        if (pos + sizeof(T) > size) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+};
+
+constexpr int kPixelFieldStart = 4; // fields 0-3 are angles, the rest are pixels
+
+} // namespace
+
+int64_t quantizeTelemetryField(int field, float value) {
+    double scale = field < kPixelFieldStart ? kTelemetryAngleScale : kTelemetryPixelScale;
+    return std::llround(static_cast<double>(value) * scale);
+}
+
+float dequantizeTelemetryField(int field, int64_t value) {
+    double scale = field < kPixelFieldStart ? kTelemetryAngleScale : kTelemetryPixelScale;
+    return static_cast<float>(static_cast<double>(value) / scale);
+}
+
+void writeTelemetryHeader(std::vector<uint8_t>& out, uint32_t keyframeInterval) {
+    putRaw<uint32_t>(out, kTelemetryMagic);
+    putRaw<uint16_t>(out, kTelemetryVersion);
+    putRaw<uint16_t>(out, 0);
+    putRaw<uint32_t>(out, keyframeInterval);
+    putRaw<uint32_t>(out, 0);
+}
+
+void writeTelemetryIndex(std::vector<uint8_t>& out, const std::vector<TelemetryIndexEntry>& index, uint64_t indexOffset) {
+    for (const TelemetryIndexEntry& entry : index) {
+        putRaw<uint64_t>(out, entry.tick);
+        putRaw<uint64_t>(out, entry.offset);
+    }
+    putRaw<uint64_t>(out, indexOffset);
+    putRaw<uint64_t>(out, index.size());
+    putRaw<uint32_t>(out, kTelemetryIndexMagic);
+}
+
+/**
+ * Function to append one frame to the telemetry stream.
+ *
+ * @param frame The frame to encode.
+ * @param keyframe Whether to write absolute values instead of deltas.
+ * @param out The buffer the encoded bytes are appended to.
+ * @return none
+ */
+void TelemetryEncoder::encode(const TelemetryFrame& frame, bool keyframe, std::vector<uint8_t>& out) {
+    size_t itemValues = frame.items.size() * 2;
+    bool itemsChanged = keyframe || itemValues != previousItems.size();
+    if (!itemsChanged) {
+        for (size_t i = 0; i < frame.items.size(); ++i) {
+            if (previousItems[2 * i] != std::llround(frame.items[i].x * kTelemetryPixelScale)
+                || previousItems[2 * i + 1] != std::llround(frame.items[i].y * kTelemetryPixelScale)) {
+                itemsChanged = true;
+                break;
+            }
+        }
+    }
+
+    uint8_t flags = 0;
+    if (keyframe) flags |= kTelemetryKeyframe;
+    if (frame.elbowUp) flags |= kTelemetryElbowUp;
+    if (frame.tracking) flags |= kTelemetryTracking;
+    if (frame.linear) flags |= kTelemetryLinear;
+    if (frame.itemGrabbed) flags |= kTelemetryItemGrabbed;
+    if (!frame.commands.empty()) flags |= kTelemetryHasCommands;
+    if (itemsChanged) flags |= kTelemetryItemsChanged;
+    out.push_back(flags);
+
+    if (keyframe) {
+        putVarint(out, frame.tick);
+        for (int i = 0; i < TelemetryFrame::kFieldCount; ++i) {
+            putRaw<float>(out, frame.fields[i]);
+            previous[i] = quantizeTelemetryField(i, frame.fields[i]);
+        }
+    } else {
+        int64_t current[TelemetryFrame::kFieldCount];
+        uint64_t mask = 0;
+        for (int i = 0; i < TelemetryFrame::kFieldCount; ++i) {
+            current[i] = quantizeTelemetryField(i, frame.fields[i]);
+            if (current[i] != previous[i]) mask |= 1u << i;
+        }
+        putVarint(out, mask);
+        for (int i = 0; i < TelemetryFrame::kFieldCount; ++i) {
+            if (mask & (1u << i)) putSigned(out, current[i] - previous[i]);
+            previous[i] = current[i];
+        }
+    }
+
+    if (itemsChanged) {
+        putVarint(out, frame.items.size());
+        previousItems.resize(itemValues, 0);
+        for (size_t i = 0; i < frame.items.size(); ++i) {
+            int64_t x = std::llround(frame.items[i].x * kTelemetryPixelScale);
+            int64_t y = std::llround(frame.items[i].y * kTelemetryPixelScale);
+            if (keyframe) {
+                putRaw<float>(out, frame.items[i].x);
+                putRaw<float>(out, frame.items[i].y);
+            } else {
+                putSigned(out, x - previousItems[2 * i]);
+                putSigned(out, y - previousItems[2 * i + 1]);
+            }
+            previousItems[2 * i] = x;
+            previousItems[2 * i + 1] = y;
+        }
+    }
+
+    if (!frame.commands.empty()) {
+        putVarint(out, frame.commands.size());
+        for (const ArmCommand& command : frame.commands) {
+            out.push_back(static_cast<uint8_t>(command.type));
+            putRaw<float>(out, command.a);
+            putRaw<float>(out, command.b);
+        }
+    }
+}
+
+/**
+ * Function to decode one frame from the telemetry stream.
+ *
+ * @param data Pointer to the first byte of the frame.
+ * @param size Number of bytes available at data.
+ * @param frame The decoded frame (output).
+ * @return The number of bytes consumed, or 0 if the input is truncated or malformed.
+ */
+size_t TelemetryDecoder::decode(const uint8_t* data, size_t size, TelemetryFrame& frame) {
+    Reader in{data, size};
+    uint8_t flags = in.raw<uint8_t>();
+    bool keyframe = flags & kTelemetryKeyframe;
+
+    if (keyframe) {
+        frame.tick = in.varint();
+        for (int i = 0; i < TelemetryFrame::kFieldCount; ++i) {
+            frame.fields[i] = in.raw<float>();
+            previous[i] = quantizeTelemetryField(i, frame.fields[i]);
+        }
+    } else {
+        frame.tick = nextTick;
+        uint64_t mask = in.varint();
+        for (int i = 0; i < TelemetryFrame::kFieldCount; ++i) {
+            if (mask & (1u << i)) previous[i] += in.signedVarint();
+            frame.fields[i] = dequantizeTelemetryField(i, previous[i]);
+        }
+    }
+    nextTick = frame.tick + 1;
+    frame.elbowUp = flags & kTelemetryElbowUp;
+    frame.tracking = flags & kTelemetryTracking;
+    frame.linear = flags & kTelemetryLinear;
+    frame.itemGrabbed = flags & kTelemetryItemGrabbed;
+
+    if (flags & kTelemetryItemsChanged) {
+        uint64_t count = in.varint();
+        if (count > size) return 0;
+        previousItems.resize(count * 2, 0);
+        frame.items.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (keyframe) {
+                frame.items[i].x = in.raw<float>();
+                frame.items[i].y = in.raw<float>();
+                previousItems[2 * i] = std::llround(frame.items[i].x * kTelemetryPixelScale);
+                previousItems[2 * i + 1] = std::llround(frame.items[i].y * kTelemetryPixelScale);
+            } else {
+                previousItems[2 * i] += in.signedVarint();
+                previousItems[2 * i + 1] += in.signedVarint();
+                frame.items[i].x = static_cast<float>(previousItems[2 * i] / kTelemetryPixelScale);
+                frame.items[i].y = static_cast<float>(previousItems[2 * i + 1] / kTelemetryPixelScale);
+            }
+        }
+    } else {
+        frame.items.resize(previousItems.size() / 2);
+        for (size_t i = 0; i < frame.items.size(); ++i) {
+            frame.items[i].x = static_cast<float>(previousItems[2 * i] / kTelemetryPixelScale);
+            frame.items[i].y = static_cast<float>(previousItems[2 * i + 1] / kTelemetryPixelScale);
+        }
+    }
+
+    frame.commands.clear();
+    if (flags & kTelemetryHasCommands) {
+        uint64_t count = in.varint();
+        if (count > size) return 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            ArmCommand command;
+            command.type = static_cast<ArmCommand::Type>(in.raw<uint8_t>());
+            command.a = in.raw<float>();
+            command.b = in.raw<float>();
+            frame.commands.push_back(command);
+        }
+    }
+
+    return in.ok ? in.pos : 0;
+}
@@ -0,0 +1,106 @@
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Command.h"
+
+/*
+ * Compact binary telemetry format (*.armt).
+ *
+ *   file    := header frame* index trailer
+ *   header  := "ARMT" u32 magic, u16 version, u16 reserved, u32 keyframeInterval, u32 reserved
+ *   frame   := u8 flags, keyframe-body | delta-body, [commands]
+ *
+ * Keyframes (every keyframeInterval ticks) store the tick and every field as a
+ * raw float, so decoding can start at any keyframe and the exact simulation
+ * state can be restored there. Delta frames store a varint bit mask of the
+ * fields that changed and a zigzag varint of each change, quantized to
+ * kTelemetryAngleScale steps per radian and kTelemetryPixelScale steps per
+ * pixel. Deltas are taken against the decoder's reconstruction, so
+ * quantization error never accumulates. The commands applied in a tick
+ * follow the frame body verbatim. The index at the end maps keyframe ticks
+ * to file offsets.
+ */
+
+constexpr uint32_t kTelemetryMagic = 0x544D5241; // "ARMT"
+constexpr uint32_t kTelemetryIndexMagic = 0x494D5241; // "ARMI"
+constexpr uint16_t kTelemetryVersion = 3;
+constexpr double kTelemetryAngleScale = 1 << 20; // ~1e-6 rad
+constexpr double kTelemetryPixelScale = 64;      // 1/64 px
+
+enum TelemetryFlags : uint8_t {
+    kTelemetryKeyframe = 1 << 0,
+    kTelemetryElbowUp = 1 << 1,
+    kTelemetryItemGrabbed = 1 << 2,
+    kTelemetryHasCommands = 1 << 3,
+    kTelemetryItemsChanged = 1 << 4,
+    kTelemetryTracking = 1 << 5,
+    kTelemetryLinear = 1 << 6
+};
+
+struct TelemetryItem {
+    float x;
+    float y;
+};
+
+// Per-tick arm state as recorded
+struct TelemetryFrame {
+    static constexpr int kFieldCount = 15;
+
+    uint64_t tick = 0;
+    // currentAngle1, currentAngle2, targetAngle1, targetAngle2, tx, ty, px, py, L1, L2, trackX, trackY,
+    // linearX0, linearY0, linearS
+    float fields[kFieldCount] = {};
+    bool elbowUp = false;
+    bool tracking = false;
+    bool linear = false;
+    bool itemGrabbed = false;
+    std::vector<TelemetryItem> items;
+    std::vector<ArmCommand> commands; // commands applied at the start of this tick
+};
+
+struct TelemetryIndexEntry {
+    uint64_t tick;
+    uint64_t offset;
+};
+
+/**
+ * Encodes frames into the delta/varint stream. Keeps the decoder-side
+ * reconstruction of the previous frame so deltas stay drift free.
+ */
+class TelemetryEncoder {
+public:
+    void encode(const TelemetryFrame& frame, bool keyframe, std::vector<uint8_t>& out);
+
+private:
+    int64_t previous[TelemetryFrame::kFieldCount] = {};
+    std::vector<int64_t> previousItems; // x0, y0, x1, y1, ...
+};
+
+/**
+ * Decodes frames from the stream. After a keyframe has been decoded any
+ * following delta frame can be decoded.
+ */
+class TelemetryDecoder {
+public:
+    // Decode the frame at `data`; returns the number of bytes consumed or 0 on malformed input
+    size_t decode(const uint8_t* data, size_t size, TelemetryFrame& frame);
+
+private:
+    int64_t previous[TelemetryFrame::kFieldCount] = {};
+    std::vector<int64_t> previousItems;
+    uint64_t nextTick = 0;
+};
+
+int64_t quantizeTelemetryField(int field, float value);
+float dequantizeTelemetryField(int field, int64_t value);
+
+void writeTelemetryHeader(std::vector<uint8_t>& out, uint32_t keyframeInterval);
+void writeTelemetryIndex(std::vector<uint8_t>& out, const std::vector<TelemetryIndexEntry>& index, uint64_t indexOffset);
+
+constexpr size_t kTelemetryHeaderSize = 16;
+constexpr size_t kTelemetryTrailerSize = 20;
+
+#endif // TELEMETRY_HPP
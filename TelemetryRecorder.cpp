@@ -0,0 +1,127 @@
+#include "TelemetryRecorder.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <cstring>
+
+TelemetryRecorder::~TelemetryRecorder() {
+    close();
+}
+
+/**
+ * Function to start recording to a file.
+ *
+ * @param path The output file (conventionally *.armt).
+ * @param keyframeInterval Number of ticks between keyframes.
+ * @return true if the file was created.
+ */
+bool TelemetryRecorder::open(const std::string& path, uint32_t keyframeInterval) {
+    close();
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        logError("Failed to open telemetry file ", path, ": ", std::strerror(errno));
+        return false;
+    }
+
+    this->path = path;
+    writeError = 0;
+    this->keyframeInterval = keyframeInterval > 0 ? keyframeInterval : 1;
+    encoder = TelemetryEncoder();
+    tick = 0;
+    index.clear();
+    active.clear();
+    active.reserve(2 * kFlushThreshold);
+    pending.reserve(2 * kFlushThreshold);
+    writeTelemetryHeader(active, this->keyframeInterval);
+    streamOffset = active.size();
+
+    stopping = false;
+    pendingReady = false;
+    writer = std::thread(&TelemetryRecorder::writerLoop, this);
+    logInfo("Recording telemetry to ", path);
+    return true;
+}
+
+/**
+ * Function to finish the recording.
+ *
+ * Flushes the remaining frames, appends the keyframe index and closes the file.
+ *
+ * @return false if a write or the close failed; the file is then truncated.
+ */
+bool TelemetryRecorder::close() {
+    if (!file) return true;
+
+    writeTelemetryIndex(active, index, streamOffset);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this] { return !pendingReady; });
+        stopping = true;
+    }
+    wake.notify_all();
+    writer.join();
+
+    if (writeError == 0 && std::fwrite(active.data(), 1, active.size(), file) != active.size()) writeError = errno != 0 ? errno : EIO;
+    if (std::fclose(file) != 0 && writeError == 0) writeError = errno != 0 ? errno : EIO;
+    file = nullptr;
+    if (writeError != 0) {
+        logError("Failed to write telemetry file ", path, ": ", std::strerror(writeError), "; the recording is incomplete");
+        return false;
+    }
+    logInfo("Telemetry: ", tick, " ticks, ", streamOffset, " bytes");
+    return true;
+}
+
+/**
+ * Function to record one tick of telemetry.
+ *
+ * @param frame The arm state and the commands applied this tick.
+ * @return none
+ */
+void TelemetryRecorder::record(TelemetryFrame& frame) {
+    if (!file) return;
+
+    frame.tick = tick;
+    bool keyframe = tick % keyframeInterval == 0;
+    if (keyframe) index.push_back({tick, streamOffset});
+
+    size_t before = active.size();
+    encoder.encode(frame, keyframe, active);
+    streamOffset += active.size() - before;
+    ++tick;
+
+    if (active.size() >= kFlushThreshold) handOff();
+}
+
+// Swap the active buffer with the writer's if the writer is idle; never blocks on I/O
+void TelemetryRecorder::handOff() {
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock() || pendingReady) return;
+
+    std::swap(active, pending);
+    active.clear();
+    pendingReady = true;
+    lock.unlock();
+    wake.notify_all();
+}
+
+void TelemetryRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return pendingReady || stopping; });
+        if (!pendingReady) return;
+
+        // Write outside the lock so the simulation can keep handing off; after a failure the rest is dropped
+        bool skip = writeError != 0;
+        lock.unlock();
+        int error = 0;
+        if (!skip && std::fwrite(pending.data(), 1, pending.size(), file) != pending.size()) error = errno != 0 ? errno : EIO;
+        lock.lock();
+        if (error != 0) writeError = error;
+
+        pending.clear();
+        pendingReady = false;
+        wake.notify_all();
+    }
+}
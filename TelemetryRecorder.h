@@ -0,0 +1,61 @@
+#ifndef TELEMETRYRECORDER_HPP
+#define TELEMETRYRECORDER_HPP
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Telemetry.h"
+
+/**
+ * Records per-tick telemetry frames to a file.
+ *
+ * Frames are encoded on the calling thread into the active buffer. Full
+ * buffers are handed to a background writer thread (double buffering), and
+ * the simulation thread never waits on disk I/O. If the writer falls behind,
+ * the active buffer just keeps growing until the writer is free. After a
+ * failed write nothing more is written, and close() reports the recording
+ * as failed.
+ */
+class TelemetryRecorder {
+public:
+    TelemetryRecorder() = default;
+    ~TelemetryRecorder();
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    bool open(const std::string& path, uint32_t keyframeInterval = 1000);
+    bool close(); // False if any part of the recording could not be written
+    bool isOpen() const { return file != nullptr; }
+
+    // Encode one tick; the frame's tick field is assigned by the recorder
+    void record(TelemetryFrame& frame);
+
+private:
+    void writerLoop();
+    void handOff();
+
+    static constexpr size_t kFlushThreshold = 256 * 1024;
+
+    FILE* file = nullptr;
+    std::string path;
+    int writeError = 0; // errno of the first failed write; set by the writer thread under the mutex
+    TelemetryEncoder encoder;
+    uint32_t keyframeInterval = 1000;
+    uint64_t tick = 0;
+    uint64_t streamOffset = 0; // bytes encoded so far, including the header
+    std::vector<TelemetryIndexEntry> index;
+
+    std::vector<uint8_t> active;  // filled by the simulation thread
+    std::vector<uint8_t> pending; // being written by the writer thread
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool pendingReady = false;
+    bool stopping = false;
+    std::thread writer;
+};
+
+#endif // TELEMETRYRECORDER_HPP
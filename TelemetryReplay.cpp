@@ -0,0 +1,166 @@
+#include "TelemetryReplay.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TelemetryReplay::~TelemetryReplay() {
+    close();
+}
+
+/**
+ * Function to open a recording.
+ *
+ * @param path The telemetry file written by TelemetryRecorder.
+ * @return true if the file is a valid recording with at least one keyframe.
+ */
+bool TelemetryReplay::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        logError("Failed to open recording ", path, ": ", std::strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < kTelemetryHeaderSize) {
+        logError("Recording ", path, " is too small");
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        logError("Failed to map recording ", path, ": ", std::strerror(errno));
+        return false;
+    }
+    data = static_cast<const uint8_t*>(memory);
+
+    uint32_t magic;
+    uint16_t version;
+    std::memcpy(&magic, data, sizeof(magic));
+    std::memcpy(&version, data + 4, sizeof(version));
+    std::memcpy(&interval, data + 8, sizeof(interval));
+    if (magic != kTelemetryMagic || version != kTelemetryVersion) {
+        logError("Recording ", path, " has an unknown format");
+        close();
+        return false;
+    }
+
+    // Prefer the index written at close; fall back to a scan for truncated files
+    index.clear();
+    bool indexed = false;
+    if (size >= kTelemetryHeaderSize + kTelemetryTrailerSize) {
+        const uint8_t* trailer = data + size - kTelemetryTrailerSize;
+        uint64_t indexOffset, count;
+        uint32_t indexMagic;
+        std::memcpy(&indexOffset, trailer, 8);
+        std::memcpy(&count, trailer + 8, 8);
+        std::memcpy(&indexMagic, trailer + 16, 4);
+        // Bounds are checked before multiplying so a corrupt count cannot overflow or size the index
+        size_t indexSpace = size - kTelemetryTrailerSize;
+        if (indexMagic == kTelemetryIndexMagic && count > 0 && indexOffset >= kTelemetryHeaderSize
+            && indexOffset <= indexSpace && count <= (indexSpace - indexOffset) / 16
+            && indexOffset + count * 16 == indexSpace) {
+            index.resize(count);
+            indexed = true;
+            for (uint64_t i = 0; i < count; ++i) {
+                std::memcpy(&index[i].tick, data + indexOffset + 16 * i, 8);
+                std::memcpy(&index[i].offset, data + indexOffset + 16 * i + 8, 8);
+                if (index[i].offset < kTelemetryHeaderSize || index[i].offset >= indexOffset) indexed = false;
+            }
+            if (indexed) framesEnd = indexOffset;
+            else index.clear();
+        }
+    }
+    if (!indexed && !rebuildIndex()) {
+        logError("Recording ", path, " has no frames");
+        close();
+        return false;
+    }
+    if (index.empty()) {
+        close();
+        return false;
+    }
+
+    position = index.front().offset;
+    logInfo("Replaying ", path, " (", index.size(), " keyframes)");
+    return true;
+}
+
+void TelemetryReplay::close() {
+    if (!data) return;
+    ::munmap(const_cast<uint8_t*>(data), size);
+    data = nullptr;
+    size = 0;
+    index.clear();
+}
+
+// Decode every frame once to find the keyframes; used when the trailer is missing
+bool TelemetryReplay::rebuildIndex() {
+    TelemetryDecoder scanner;
+    TelemetryFrame frame;
+    size_t at = kTelemetryHeaderSize;
+    while (at < size) {
+        bool keyframe = data[at] & kTelemetryKeyframe;
+        if (!keyframe && index.empty()) break;
+        size_t used = scanner.decode(data + at, size - at, frame);
+        if (used == 0) break;
+        if (keyframe) index.push_back({frame.tick, at});
+        at += used;
+    }
+    framesEnd = at;
+    return !index.empty();
+}
+
+/**
+ * Function to seek to the keyframe at or before a tick.
+ *
+ * @param tick The requested tick.
+ * @param frame The keyframe (output).
+ * @return true on success.
+ */
+bool TelemetryReplay::seekKeyframe(uint64_t tick, TelemetryFrame& frame) {
+    if (!data) return false;
+
+    // Binary search for the last keyframe with keyframe.tick <= tick
+    auto it = std::upper_bound(index.begin(), index.end(), tick,
+                               [](uint64_t t, const TelemetryIndexEntry& entry) { return t < entry.tick; });
+    if (it != index.begin()) --it;
+
+    position = it->offset;
+    decoder = TelemetryDecoder();
+    return next(frame);
+}
+
+/**
+ * Function to seek to a tick.
+ *
+ * Finds the nearest keyframe in O(log n) and decodes forward to the tick.
+ *
+ * @param tick The requested tick.
+ * @param frame The frame at that tick (output).
+ * @return true on success.
+ */
+bool TelemetryReplay::seek(uint64_t tick, TelemetryFrame& frame) {
+    if (!seekKeyframe(tick, frame)) return false;
+    TelemetryFrame following;
+    while (frame.tick < tick && next(following)) {
+        std::swap(frame, following);
+    }
+    return true;
+}
+
+bool TelemetryReplay::next(TelemetryFrame& frame) {
+    if (!data || position >= framesEnd) return false;
+    size_t used = decoder.decode(data + position, framesEnd - position, frame);
+    if (used == 0) return false;
+    position += used;
+    return true;
+}
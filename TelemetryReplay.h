@@ -0,0 +1,53 @@
+#ifndef TELEMETRYREPLAY_HPP
+#define TELEMETRYREPLAY_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Telemetry.h"
+
+/**
+ * Reads a telemetry recording for replay.
+ *
+ * The file is memory-mapped and the keyframe index is read from its trailer
+ * (or rebuilt with one scan if the recording was cut short), so seek() finds
+ * the nearest keyframe by binary search and decodes at most one keyframe
+ * interval of frames.
+ */
+class TelemetryReplay {
+public:
+    TelemetryReplay() = default;
+    ~TelemetryReplay();
+
+    TelemetryReplay(const TelemetryReplay&) = delete;
+    TelemetryReplay& operator=(const TelemetryReplay&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    // Position at `tick` and decode that frame. Ticks past the end clamp to the last frame.
+    bool seek(uint64_t tick, TelemetryFrame& frame);
+
+    // Position at the keyframe at or before `tick` and decode it (the exact state there)
+    bool seekKeyframe(uint64_t tick, TelemetryFrame& frame);
+
+    // Decode the next frame; false at the end of the recording
+    bool next(TelemetryFrame& frame);
+
+    uint32_t keyframeInterval() const { return interval; }
+    const std::vector<TelemetryIndexEntry>& keyframes() const { return index; }
+
+private:
+    bool rebuildIndex();
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t framesEnd = 0; // first byte after the last frame
+    size_t position = 0;
+    uint32_t interval = 0;
+    std::vector<TelemetryIndexEntry> index;
+    TelemetryDecoder decoder;
+};
+
+#endif // TELEMETRYREPLAY_HPP
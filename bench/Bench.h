@@ -0,0 +1,49 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Keep the optimizer from discarding a benchmarked result
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;    // median over the repetitions
+    double minNsPerOp;
+};
+
+/**
+ * Times `body(i)` for `iterations` calls, repeated `repetitions` times after one
+ * warm-up run, and reports the median and minimum cost per call.
+ */
+template <typename F>
+BenchResult runBenchmark(const std::string& name, uint64_t iterations, F&& body, int repetitions = 7) {
+    std::vector<double> samples;
+    for (int r = -1; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) body(i);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (r >= 0) samples.push_back(ns / static_cast<double>(iterations));
+    }
+    std::sort(samples.begin(), samples.end());
+    return {name, iterations, samples[samples.size() / 2], samples.front()};
+}
+
+// One JSON object per line so results can be diffed, grepped and loaded by scripts
+inline void printBenchResult(const BenchResult& result) {
+    std::printf("{\"name\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.3f,\"min_ns_per_op\":%.3f,\"ops_per_s\":%.0f}\n",
+                result.name.c_str(), static_cast<unsigned long long>(result.iterations), result.nsPerOp,
+                result.minNsPerOp, result.nsPerOp > 0 ? 1e9 / result.nsPerOp : 0.0);
+    std::fflush(stdout);
+}
+
+#endif // BENCH_HPP
@@ -0,0 +1,256 @@
+// Accuracy-vs-speed regression harness for the IK solver variants.
+//
+// Usage: accuracy_harness [--step px] [--tolerance px]
+//
+// Variants: float and double are the exact solver in that precision, fast
+// uses the FastMath approximations, and lanes is the same FastMath math run
+// FloatLanes::kWidth targets at a time (8 with AVX, 4 otherwise) through the
+// branch-free kernel. cordic_q12 and cordic_q8 are the controllers'
+// fixed-point solver in those Q formats, fed targets rounded to the format;
+// their lines carry a checksum of the raw fixed-point angles, which a
+// controller build running the same grid must reproduce exactly. On the
+// default grid the checksums are compared with the golden values below.
+//
+// Every variant solves a dense grid of reachable targets for several L1/L2
+// ratios. The angles it returns are run through double-precision forward
+// kinematics, and the distance from the target is its end-effector error in
+// pixels. One JSON line per variant and ratio is printed with the error
+// percentiles and throughput. The last line names the fastest variant whose
+// worst-case error stays within the tolerance. The exit status is non-zero if
+// the reference variant itself exceeds the tolerance or a checksum differs
+// from its golden value.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Bench.h"
+#include "../FixedKinematics.h"
+#include "../Kinematics.h"
+
+namespace {
+
+struct Target {
+    float x, y;
+};
+
+// Solves targets[0..count) for an arm pivoted at the origin
+using SolveBatch = void (*)(const Target* targets, size_t count, float L1, float L2, ArmSolution* up, ArmSolution* down,
+                            IkResult* results);
+
+template <IkResult (*Solve)(float, float, float, float, float, float, ArmSolution&, ArmSolution&)>
+void solveEach(const Target* targets, size_t count, float L1, float L2, ArmSolution* up, ArmSolution* down, IkResult* results) {
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = Solve(0, 0, targets[i].x, targets[i].y, L1, L2, up[i], down[i]);
+    }
+}
+
+// Solves in double and rounds the angles to float
+void solveDouble(const Target* targets, size_t count, float L1, float L2, ArmSolution* up, ArmSolution* down, IkResult* results) {
+    for (size_t i = 0; i < count; ++i) {
+        BasicArmSolution<double> u, d;
+        results[i] = solveArmConfigurations<double>(0, 0, targets[i].x, targets[i].y, L1, L2, u, d);
+        up[i] = {static_cast<float>(u.angle1), static_cast<float>(u.angle2)};
+        down[i] = {static_cast<float>(d.angle1), static_cast<float>(d.angle2)};
+    }
+}
+
+// Solves FloatLanes::kWidth targets per call of the branch-free kernel
+void solveLanes(const Target* targets, size_t count, float L1, float L2, ArmSolution* up, ArmSolution* down, IkResult* results) {
+    constexpr size_t width = FloatLanes::kWidth;
+    for (size_t base = 0; base < count; base += width) {
+        size_t n = std::min(width, count - base);
+        FloatLanes dx(0), dy(0);
+        for (size_t k = 0; k < n; ++k) {
+            dx.lane[k] = targets[base + k].x;
+            dy.lane[k] = targets[base + k].y;
+        }
+        BasicArmSolution<FloatLanes> u, d;
+        LaneMask reachable = solveArmKernel<FloatLanes>(dx, dy, L1, L2, u, d);
+        for (size_t k = 0; k < n; ++k) {
+            up[base + k] = {u.angle1.lane[k], u.angle2.lane[k]};
+            down[base + k] = {d.angle1.lane[k], d.angle2.lane[k]};
+            results[base + k] = reachable.lane[k] ? IkResult::Ok : IkResult::OutOfReach;
+        }
+    }
+}
+
+// Solves in fixed point, as a controller given targets rounded to Format
+template <typename Format>
+void solveFixed(const Target* targets, size_t count, float L1, float L2, ArmSolution* up, ArmSolution* down, IkResult* results) {
+    int32_t fixedL1 = toFixedLength<Format>(L1), fixedL2 = toFixedLength<Format>(L2);
+    for (size_t i = 0; i < count; ++i) {
+        FixedArmSolution u, d;
+        results[i] = solveArmConfigurationsFixed<Format>(0, 0, toFixedLength<Format>(targets[i].x),
+                                                         toFixedLength<Format>(targets[i].y), fixedL1, fixedL2, u, d);
+        up[i] = {fromFixedAngle<Format>(u.angle1), fromFixedAngle<Format>(u.angle2)};
+        down[i] = {fromFixedAngle<Format>(d.angle1), fromFixedAngle<Format>(d.angle2)};
+    }
+}
+
+// FNV-1a over the result and raw angles of every target
+template <typename Format>
+uint64_t checksumFixed(const Target* targets, size_t count, float L1, float L2) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](int32_t value) {
+        for (int b = 0; b < 4; ++b) hash = (hash ^ ((static_cast<uint32_t>(value) >> (8 * b)) & 0xFF)) * 1099511628211ull;
+    };
+    int32_t fixedL1 = toFixedLength<Format>(L1), fixedL2 = toFixedLength<Format>(L2);
+    for (size_t i = 0; i < count; ++i) {
+        FixedArmSolution u{0, 0}, d{0, 0};
+        IkResult result = solveArmConfigurationsFixed<Format>(0, 0, toFixedLength<Format>(targets[i].x),
+                                                              toFixedLength<Format>(targets[i].y), fixedL1, fixedL2, u, d);
+        mix(static_cast<int32_t>(result));
+        mix(u.angle1);
+        mix(u.angle2);
+        mix(d.angle1);
+        mix(d.angle2);
+    }
+    return hash;
+}
+
+struct LinkRatio {
+    float L1, L2;
+};
+
+const LinkRatio kRatios[] = {{100, 100}, {150, 50}, {120, 80}, {60, 140}, {200, 20}};
+constexpr size_t kRatioCount = sizeof(kRatios) / sizeof(kRatios[0]);
+constexpr float kDefaultStep = 0.5f;
+
+// Checksums of the fixed-point variants on the default grid, one per entry of
+// kRatios. Any change to a raw angle or result changes them; update them only
+// together with an intended change to FixedKinematics.
+const uint64_t kGoldenQ12[kRatioCount] = {0x515070d53eaea1bcull, 0xcbbab0d764501628ull, 0x6a1750d342f303e3ull,
+                                          0x0fb1455b860a2ba0ull, 0xd992bda15ce2b7cfull};
+const uint64_t kGoldenQ8[kRatioCount] = {0x54ba7f41e8df06a3ull, 0x1140a31c221a7c0cull, 0xee5be20ccbd4c0f2ull,
+                                         0x5e27a9d18e935c4bull, 0x7459194d4bf084c7ull};
+
+struct SolverVariant {
+    const char* name;
+    SolveBatch solve;
+    uint64_t (*checksum)(const Target*, size_t, float, float); // Bit-exact variants only
+    const uint64_t* golden;                                    // Expected checksum per ratio
+};
+
+// The first entry is the reference the others are compared against
+const SolverVariant kVariants[] = {
+    {"float", solveEach<solveArmConfigurations<float>>, nullptr, nullptr},
+    {"fast", solveEach<solveArmConfigurationsFast>, nullptr, nullptr},
+    {"double", solveDouble, nullptr, nullptr},
+    {"lanes", solveLanes, nullptr, nullptr},
+    {"cordic_q12", solveFixed<FixedQ12>, checksumFixed<FixedQ12>, kGoldenQ12},
+    {"cordic_q8", solveFixed<FixedQ8>, checksumFixed<FixedQ8>, kGoldenQ8},
+};
+
+double effectorError(const Target& target, const ArmSolution& solution, float L1, float L2) {
+    double a1 = solution.angle1, a2 = solution.angle2;
+    double x = L1 * std::cos(a1) + L2 * std::cos(a1 + a2);
+    double y = L1 * std::sin(a1) + L2 * std::sin(a1 + a2);
+    return std::hypot(x - target.x, y - target.y);
+}
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0;
+    size_t k = std::min(values.size() - 1, static_cast<size_t>(p * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<long>(k), values.end());
+    return values[k];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    float step = kDefaultStep;
+    double tolerance = 0.5;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--step") step = std::stof(argv[i + 1]);
+        else if (arg == "--tolerance") tolerance = std::stod(argv[i + 1]);
+    }
+
+    constexpr size_t variantCount = sizeof(kVariants) / sizeof(kVariants[0]);
+    double worstError[variantCount] = {};
+    double throughputSum[variantCount] = {};
+
+    bool checkGolden = step == kDefaultStep; // The golden checksums are for the default grid only
+    size_t mismatches = 0;
+
+    for (size_t r = 0; r < kRatioCount; ++r) {
+        const LinkRatio& ratio = kRatios[r];
+        // Dense grid over the reachable annulus, pivot at the origin
+        std::vector<Target> targets;
+        float reach = ratio.L1 + ratio.L2;
+        double minReach = std::fabs(ratio.L1 - ratio.L2);
+        for (float y = -reach; y <= reach; y += step) {
+            for (float x = -reach; x <= reach; x += step) {
+                double d = std::hypot(static_cast<double>(x), static_cast<double>(y));
+                if (d <= reach && d >= minReach) targets.push_back({x, y});
+            }
+        }
+
+        for (size_t v = 0; v < variantCount; ++v) {
+            const SolverVariant& variant = kVariants[v];
+            std::vector<ArmSolution> up(targets.size()), down(targets.size());
+            std::vector<IkResult> results(targets.size());
+
+            // Throughput: best of three passes over the grid
+            double bestSeconds = 1e30;
+            for (int pass = 0; pass < 3; ++pass) {
+                auto start = std::chrono::steady_clock::now();
+                variant.solve(targets.data(), targets.size(), ratio.L1, ratio.L2, up.data(), down.data(), results.data());
+                doNotOptimize(results.data());
+                bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            // Error of both configurations; rejected targets are counted, not measured
+            std::vector<double> errors;
+            errors.reserve(2 * targets.size());
+            size_t rejected = 0;
+            for (size_t i = 0; i < targets.size(); ++i) {
+                if (results[i] != IkResult::Ok) {
+                    ++rejected;
+                    continue;
+                }
+                errors.push_back(effectorError(targets[i], up[i], ratio.L1, ratio.L2));
+                errors.push_back(effectorError(targets[i], down[i], ratio.L1, ratio.L2));
+            }
+
+            double maxError = errors.empty() ? 0 : *std::max_element(errors.begin(), errors.end());
+            double p50 = percentile(errors, 0.50);
+            double p99 = percentile(errors, 0.99);
+            double p999 = percentile(errors, 0.999);
+            double throughput = static_cast<double>(targets.size()) / bestSeconds;
+            worstError[v] = std::max(worstError[v], maxError);
+            throughputSum[v] += throughput;
+
+            char checksum[80] = "";
+            if (variant.checksum) {
+                uint64_t value = variant.checksum(targets.data(), targets.size(), ratio.L1, ratio.L2);
+                int n = std::snprintf(checksum, sizeof(checksum), ",\"checksum\":\"%016llx\"", static_cast<unsigned long long>(value));
+                if (checkGolden && value != variant.golden[r]) {
+                    std::snprintf(checksum + n, sizeof(checksum) - n, ",\"expected\":\"%016llx\"",
+                                  static_cast<unsigned long long>(variant.golden[r]));
+                    ++mismatches;
+                }
+            }
+            std::printf("{\"variant\":\"%s\",\"L1\":%g,\"L2\":%g,\"targets\":%zu,\"rejected\":%zu,"
+                        "\"max_px\":%.6g,\"p50_px\":%.6g,\"p99_px\":%.6g,\"p999_px\":%.6g,\"targets_per_s\":%.0f%s}\n",
+                        variant.name, ratio.L1, ratio.L2, targets.size(), rejected, maxError, p50, p99, p999, throughput, checksum);
+        }
+    }
+
+    // Pick the fastest variant that stays within tolerance for every ratio
+    const char* best = nullptr;
+    double bestThroughput = 0;
+    for (size_t v = 0; v < variantCount; ++v) {
+        if (worstError[v] <= tolerance && throughputSum[v] > bestThroughput) {
+            best = kVariants[v].name;
+            bestThroughput = throughputSum[v];
+        }
+    }
+    std::printf("{\"tolerance_px\":%g,\"recommended\":\"%s\",\"checksum_mismatches\":%zu}\n", tolerance, best ? best : "none",
+                mismatches);
+
+    return worstError[0] <= tolerance && mismatches == 0 ? 0 : 1;
+}
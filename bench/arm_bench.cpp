@@ -0,0 +1,189 @@
+// Microbenchmarks for the kinematics and drawing primitives.
+//
+// Usage: arm_bench [filter]
+//
+// Prints one JSON object per benchmark on stdout (see Bench.h). Only benchmarks
+// whose name contains `filter` are run.
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Bench.h"
+#include "../FixedKinematics.h"
+#include "../Log.h"
+#include "../RoboticArm.h"
+#include "../Simulation.h"
+
+namespace {
+
+constexpr float kPx = 400, kPy = 300, kL1 = 100, kL2 = 100;
+
+struct Target {
+    float x, y;
+};
+
+// Targets at a given distance band from the pivot, in random directions
+std::vector<Target> makeTargets(float minDistance, float maxDistance, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+    std::uniform_real_distribution<float> distance(minDistance, maxDistance);
+    std::vector<Target> targets(count);
+    for (Target& target : targets) {
+        float a = angle(rng), d = distance(rng);
+        target = {kPx + d * std::cos(a), kPy + d * std::sin(a)};
+    }
+    return targets;
+}
+
+bool selected(const std::string& name, const std::string& filter) {
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    const size_t n = 4096;
+    const uint64_t iterations = 1 << 18;
+
+    // calculateArmAngles logs unreachable targets; keep warnings out of the JSON lines and the timings
+    LogLevel level = logLevel();
+    setLogLevel(LogLevel::Error);
+
+    struct TargetSet {
+        const char* name;
+        std::vector<Target> targets;
+    };
+    TargetSet sets[] = {
+        {"reachable", makeTargets(10, kL1 + kL2 - 10, n)},
+        {"unreachable", makeTargets(kL1 + kL2 + 1, 2 * (kL1 + kL2), n)},
+        {"near_singular", makeTargets(kL1 + kL2 - 0.01f, kL1 + kL2, n)},
+    };
+
+    std::vector<BenchResult> results;
+    for (const TargetSet& set : sets) {
+        std::string name = std::string("calculateArmAngles/") + set.name;
+        if (selected(name, filter)) {
+            float angle1 = 0, angle2 = 0;
+            bool elbowUp = false;
+            results.push_back(runBenchmark(name, iterations, [&](uint64_t i) {
+                const Target& t = set.targets[i & (n - 1)];
+                calculateArmAngles(kPx, kPy, t.x, t.y, kL1, kL2, angle1, angle2, elbowUp);
+                doNotOptimize(angle1);
+            }));
+        }
+
+        name = std::string("solveArmConfigurations/") + set.name;
+        if (selected(name, filter)) {
+            results.push_back(runBenchmark(name, iterations, [&](uint64_t i) {
+                const Target& t = set.targets[i & (n - 1)];
+                ArmSolution up, down;
+                IkResult result = solveArmConfigurations(kPx, kPy, t.x, t.y, kL1, kL2, up, down);
+                doNotOptimize(result);
+                doNotOptimize(up);
+            }));
+        }
+
+        // The controllers' solver on targets already in fixed point, as they receive them
+        name = std::string("solveArmConfigurationsFixed/") + set.name;
+        if (selected(name, filter)) {
+            std::vector<int32_t> fixedTargets;
+            for (const Target& t : set.targets) {
+                fixedTargets.push_back(toFixedLength<FixedQ12>(t.x));
+                fixedTargets.push_back(toFixedLength<FixedQ12>(t.y));
+            }
+            int32_t px = toFixedLength<FixedQ12>(kPx), py = toFixedLength<FixedQ12>(kPy);
+            int32_t L1 = toFixedLength<FixedQ12>(kL1), L2 = toFixedLength<FixedQ12>(kL2);
+            results.push_back(runBenchmark(name, iterations, [&](uint64_t i) {
+                size_t k = 2 * (i & (n - 1));
+                FixedArmSolution up, down;
+                IkResult result = solveArmConfigurationsFixed<FixedQ12>(px, py, fixedTargets[k], fixedTargets[k + 1], L1, L2, up, down);
+                doNotOptimize(result);
+                doNotOptimize(up);
+            }));
+        }
+    }
+    setLogLevel(level);
+
+    if (selected("lerp", filter)) {
+        float current = 0;
+        results.push_back(runBenchmark("lerp", iterations * 16, [&](uint64_t i) {
+            current = lerp(current, (i & 1024) ? 1.0f : -1.0f, 0.001f);
+            doNotOptimize(current);
+        }));
+    }
+
+    if (selected("forwardKinematics", filter)) {
+        ArmState arm;
+        results.push_back(runBenchmark("forwardKinematics", iterations, [&](uint64_t i) {
+            arm.currentAngle1 = static_cast<float>(i & 1023) * 0.006f;
+            arm.currentAngle2 = static_cast<float>(i & 511) * 0.01f;
+            ArmPose pose = computePose(arm);
+            doNotOptimize(pose);
+        }));
+    }
+
+    if (selected("forwardKinematicsTable", filter)) {
+        ArmState arm;
+        results.push_back(runBenchmark("forwardKinematicsTable", iterations, [&](uint64_t i) {
+            arm.currentAngle1 = static_cast<float>(i & 1023) * 0.006f;
+            arm.currentAngle2 = static_cast<float>(i & 511) * 0.01f;
+            ArmPose pose = computePose(arm, FkTrig::Table);
+            doNotOptimize(pose);
+        }));
+    }
+
+    if (selected("forwardKinematicsFixed", filter)) {
+        int32_t L1 = toFixedLength<FixedQ12>(kL1), L2 = toFixedLength<FixedQ12>(kL2);
+        int32_t step1 = toFixedAngle<FixedQ12>(0.006f), step2 = toFixedAngle<FixedQ12>(0.01f);
+        results.push_back(runBenchmark("forwardKinematicsFixed", iterations, [&](uint64_t i) {
+            int32_t x2, y2, x3, y3;
+            forwardKinematicsFixed<FixedQ12>(0, 0, L1, L2, static_cast<int32_t>(i & 1023) * step1,
+                                             static_cast<int32_t>(i & 511) * step2, x2, y2, x3, y3);
+            doNotOptimize(x3);
+            doNotOptimize(y3);
+        }));
+    }
+
+    if (selected("grabCheck", filter)) {
+        // The distance test of updateGrab() against the single item
+        std::vector<Target> claws = makeTargets(0, kL1 + kL2, n);
+        float itemX = kPx + 50, itemY = kPy, grabDistance = 10;
+        results.push_back(runBenchmark("grabCheck", iterations * 4, [&](uint64_t i) {
+            const Target& claw = claws[i & (n - 1)];
+            float distToClaw = std::sqrt((itemX - claw.x) * (itemX - claw.x) + (itemY - claw.y) * (itemY - claw.y));
+            bool grab = distToClaw < grabDistance;
+            doNotOptimize(grab);
+        }));
+    }
+
+    // Drawing primitives against an offscreen render target
+    sf::RenderTexture target;
+    if (!target.create(800, 600)) {
+        std::cerr << "No offscreen render target available, skipping draw benchmarks\n";
+    } else {
+        const uint64_t drawIterations = 1 << 12;
+        auto benchDraw = [&](const std::string& name, uint64_t count, auto&& body) {
+            if (!selected(name, filter)) return;
+            BenchResult result = runBenchmark(name, count, body, 5);
+            target.display(); // flush queued GL work so it is not charged to the next benchmark
+            results.push_back(result);
+        };
+
+        benchDraw("draw/drawGrid", drawIterations / 16, [&](uint64_t) { drawGrid(target, 800, 600, 10); });
+        benchDraw("draw/drawThickLine", drawIterations, [&](uint64_t i) {
+            drawThickLine(target, 400, 300, 300 + static_cast<float>(i & 255), 200, sf::Color::Blue, 4.0f);
+        });
+        benchDraw("draw/drawClaw", drawIterations, [&](uint64_t i) {
+            drawClaw(target, 400, 300, static_cast<float>(i & 255) * 0.02f, 10.0f, 2.5f, sf::Color::Black);
+        });
+        benchDraw("draw/drawJoint", drawIterations, [&](uint64_t i) {
+            drawJoint(target, 300 + static_cast<float>(i & 255), 300);
+        });
+    }
+
+    for (const BenchResult& result : results) printBenchResult(result);
+    return 0;
+}
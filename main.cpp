@@ -3,213 +3,451 @@
 #include <cmath>
 #include <vector>
 #include "RoboticArm.h"
+#include "Simulation.h"
+#include "CommandConsole.h"
+#include "CommandServer.h"
+#include "StatePublisher.h"
+#include "TelemetryRecorder.h"
+#include "TelemetryReplay.h"
+#include "Replay.h"
+#include "Scene.h"
+#include "FrameBenchmark.h"
+#include "Conveyor.h"
+#include "PathTrace.h"
+#include "Coordinator.h"
+#include "TaskPool.h"
+#include "ControlLoop.h"
+#include "FrameArena.h"
+#include "Log.h"
+#include "Metrics.h"
+#include <chrono>
+#include <string>
+#include <thread>
+
+int main(int argc, char** argv) {
+    // Set up initial parameters
+    SimulationParams params; // Grid size, smoothing, claw length and grab distance
+    std::vector<ArmState> arms(1); // Pivot at the center of the window, L1 = L2 = 100, target at the pivot
+    unsigned width = 800, height = 600;
+
+    // Diagnostics are written by a background thread so a frame never waits for the terminal: --log-level <level>
+    LogWriter::Scope logging(logWriter());
+
+    // Console input runs on its own thread so prompts never stall the loop
+    CommandConsole console;
+
+    // Optional local command socket for external planners: --ipc <path>
+    CommandServer server;
+
+    // Optional shared-memory state ring for external viewers: --publish <name>
+    StatePublisher publisher;
+
+    // Optional telemetry recording: --record <file.armt>
+    TelemetryRecorder recorder;
+    TelemetryFrame telemetry;
+
+    // Optional replay of a recording: --replay <file.armt> [--seek <tick>] [--headless]
+    TelemetryReplay replay;
+    std::string replayPath;
+    uint64_t seekTick = 0;
+    bool headless = false;
+
+    // Optional binary scene with arms, obstacles and items: --scene <file.arms>
+    Scene scene;
+    std::string scenePath;
+
+    // Frame-time benchmark instead of the interactive window: --bench <scenario|all> [--frames <n>]
+    std::string benchScenario;
+    int benchFrames = 1000;
+
+    // Optional conveyor feeding the interactive arm: --conveyor <px/tick> [--spawn-rate <items/min>] [--headless --ticks <n>]
+    ConveyorState conveyor;
+    bool conveyorEnabled = false;
+    uint64_t headlessTicks = 600000; // Ten minutes at 1 kHz
+
+    // Optional path tracing: --trace <file.svg|file.txt> [--threads <n>]
+    std::string tracePath;
+    TraceTrajectory trace;
+    size_t traceTick = 0;
+    sf::VertexArray traceLine(sf::LineStrip);
+
+    // Work-stealing pool for the per-arm tick, coordinator planning and trace solving: --threads <n>
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    TaskPool pool;
+
+    // Optional coordination of arms with overlapping reach: --coordinate [--threads <n>] [--headless --ticks <n>]
+    CoordinatorState coordinator;
+    bool coordinate = false;
+
+    // Optional fixed-rate control thread: --control-rate <Hz> [--rt-priority <n>] [--control pd|pid|ct]
+    ControlLoop control;
+    double controlRate = 0;
+    int rtPriority = 0;
+
+    // Optional Prometheus metrics for node_exporter's textfile collector: --metrics <file.prom> [--metrics-interval <s>]
+    MetricsExporter exporter;
+    std::string metricsPath;
+    double metricsInterval = 15;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ipc" && i + 1 < argc) {
+            server.open(argv[++i]);
+        } else if (arg == "--publish" && i + 1 < argc) {
+            publisher.open(argv[++i]);
+        } else if (arg == "--record" && i + 1 < argc) {
+            recorder.open(argv[++i]);
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--seek" && i + 1 < argc) {
+            seekTick = std::stoull(argv[++i]);
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--scene" && i + 1 < argc) {
+            scenePath = argv[++i];
+        } else if (arg == "--bench" && i + 1 < argc) {
+            benchScenario = argv[++i];
+        } else if (arg == "--frames" && i + 1 < argc) {
+            benchFrames = std::stoi(argv[++i]);
+        } else if (arg == "--conveyor" && i + 1 < argc) {
+            conveyorEnabled = true;
+            conveyor.params.speed = std::stof(argv[++i]);
+        } else if (arg == "--spawn-rate" && i + 1 < argc) {
+            conveyor.params.spawnRate = std::stof(argv[++i]);
+        } else if (arg == "--ticks" && i + 1 < argc) {
+            headlessTicks = std::stoull(argv[++i]);
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::max(1, std::stoi(argv[++i])));
+        } else if (arg == "--coordinate") {
+            coordinate = true;
+        } else if (arg == "--dynamics") {
+            params.dynamics = true; // Joints follow the motion under motor torque limits
+        } else if (arg == "--payload" && i + 1 < argc) {
+            params.dynamicsParams.payload = std::stof(argv[++i]);
+        } else if (arg == "--control" && i + 1 < argc) {
+            std::string law = argv[++i];
+            params.dynamics = true;
+            params.dynamicsParams.law = law == "pid" ? ControlLaw::Pid
+                                      : law == "ct" ? ControlLaw::ComputedTorque : ControlLaw::Pd;
+        } else if (arg == "--control-rate" && i + 1 < argc) {
+            controlRate = std::stod(argv[++i]);
+        } else if (arg == "--rt-priority" && i + 1 < argc) {
+            rtPriority = std::stoi(argv[++i]);
+        } else if (arg == "--ik" && i + 1 < argc) {
+            params.ikSolver = std::string(argv[++i]) == "cordic" ? IkSolver::Cordic : IkSolver::Float; // Controllers' fixed-point IK
+        } else if (arg == "--fk" && i + 1 < argc) {
+            params.fkTrig = std::string(argv[++i]) == "table" ? FkTrig::Table : FkTrig::Std; // Lookup-table trig for drawn poses
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            metricsPath = argv[++i];
+        } else if (arg == "--metrics-interval" && i + 1 < argc) {
+            metricsInterval = std::stod(argv[++i]);
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            LogLevel level;
+            if (parseLogLevel(argv[++i], level)) setLogLevel(level);
+            else logWarning("Unknown log level ", argv[i], "; use debug, info, warning or error");
+        }
+    }
 
-bool elbowUp = false;
-std::vector<sf::CircleShape> items; // For future use if I want to add more Items
-bool itemGrabbed = false;
-sf::Vector2f grabbedItemOffset(0, 0);
+    // Recordings hold the kinematic state only and replay re-simulates without dynamics
+    if (params.dynamics && (recorder.isOpen() || !replayPath.empty())) {
+        logError("--dynamics and --control cannot be combined with --record or --replay");
+        return 1;
+    }
 
-void drawItem(int x, int y) {
-    float radius = 5.0f;  // Set a visible size
-    sf::CircleShape item(radius);
-    item.setFillColor(sf::Color::Black);
-    item.setOutlineColor(sf::Color::Black);
-    item.setOutlineThickness(1.0f);
-    item.setPosition(x - radius, y - radius);  // Center the item
+    if (threads > 1) pool.start(threads);
+    if (!metricsPath.empty() && !exporter.start(metricsPath, metricsInterval)) return 1;
 
+    if (!benchScenario.empty()) {
+        return runFrameBenchmark(benchScenario, benchFrames) ? 0 : 1;
+    }
 
-    items.clear();
-    items.push_back(item); // Store the item so it persists
-}
+    // Static scene items are drawn straight from the mapping in one batch
+    sf::VertexArray sceneItems(sf::Quads);
+    if (!scenePath.empty()) {
+        if (!scene.open(scenePath)) return 1;
+
+        arms.clear();
+        for (size_t i = 0; i < scene.armCount(); ++i) {
+            arms.push_back(armFromScene(scene.arms()[i]));
+        }
+        if (arms.empty()) arms.emplace_back();
 
-int main() {
-    sf::RenderWindow window(sf::VideoMode(800, 600), "Robotic Arm Simulation");
+        params.gridSize = scene.info().gridSize;
+        width = static_cast<unsigned>(scene.info().width);
+        height = static_cast<unsigned>(scene.info().height);
 
-    // Set up initial parameters
-    float gridSize = 10; // Grid size for visualization
-    float px = 400, py = 300; // Pivot point at the center of the window
-    float L1 = 100, L2 = 100; // Length of the arm segments
+        sceneItems = makeItemVertices(scene.items(), scene.itemCount());
+        logInfo("Loaded scene ", scenePath, ": ", scene.armCount(), " arms, ", scene.obstacleCount(), " obstacles, ",
+                scene.itemCount(), " items");
+    }
+
+    ArmState& arm = arms[0]; // The interactive arm; commands, replay and telemetry apply to it
+
+    if (!tracePath.empty()) {
+        std::vector<PathPoint> path;
+        if (!loadPath(tracePath, path)) return 1;
+        mapPathToWorkspace(path, arm);
+        if (!planTrace(path, arm, params.trackSpeed, pool, trace)) return 1;
+        reportTrace(trace);
+        if (headless && replayPath.empty()) return 0;
+        traceLine = makePathVertices(path);
+    }
+
+    if (conveyorEnabled) {
+        // Belt below the arm, drop point above it, both well inside its reach
+        float reach = 0.6f * (arm.L1 + arm.L2);
+        conveyor.params.beltY = arm.py + reach;
+        conveyor.params.endX = static_cast<float>(width);
+        conveyor.params.dropX = arm.px;
+        conveyor.params.dropY = arm.py - reach;
+        if (headless && replayPath.empty()) {
+            runHeadlessConveyor(conveyor, arms, params, headlessTicks);
+            return 0;
+        }
+    }
+
+    if (coordinate) {
+        // The coordinator moves arm 0 itself, so its moves never pass through the recorded commands
+        if (!replayPath.empty() || recorder.isOpen()) {
+            logError("--coordinate cannot be combined with --record or --replay");
+            return 1;
+        }
+        // Reservations assume the kinematic lerp; saturated motors trail it too far for the clearance to hold
+        if (params.dynamics) {
+            logError("--coordinate cannot be combined with --dynamics or --control");
+            return 1;
+        }
+        coordinator.pool = &pool;
+        if (headless && replayPath.empty()) {
+            runHeadlessCoordinator(coordinator, arms, params, headlessTicks);
+            return 0;
+        }
+    }
 
-    float tx = px; // Target starts at the pivot
-    float ty = py;
+    if (controlRate > 0) {
+        // The control thread owns the arms; modes that drive them from the frame loop cannot share them
+        if (!replayPath.empty() || coordinate || conveyorEnabled || !tracePath.empty() || recorder.isOpen()) {
+            logError("--control-rate cannot be combined with --replay, --coordinate, --conveyor, --trace or --record");
+            return 1;
+        }
+        if (!control.start(arms, params, controlRate, rtPriority, &pool)) return 1;
+    }
 
-    float targetAngle1 = 0, targetAngle2 = 0; // Target arm angles
-    float currentAngle1 = 0, currentAngle2 = 0; // Current animated arm angles
+    if (!replayPath.empty()) {
+        if (!replay.open(replayPath)) return 1;
+        if (headless) return runHeadlessReplay(replay, seekTick, params) ? 0 : 2;
+        if (!replay.seek(seekTick, telemetry)) return 1;
+        restoreTelemetry(telemetry, arm);
+    } else {
+        console.start();
+    }
 
-    float thickness = 4.0f; // Thickness of the arm
-    float smoothFactor = 0.001f; // Factor for smooth movement
+    sf::RenderWindow window(sf::VideoMode(width, height), "Robotic Arm Simulation");
+    if (control.isRunning()) window.setFramerateLimit(60); // Frames only draw the control thread's state
+    bool paused = false;
 
+    // Commands from every input source, applied together at the tick boundary
+    std::vector<ArmCommand> tickCommands;
 
-    float clawLength = 10.0f; // Length of the claw fingers
-    float clawWidth = 2.5f;   // Width of the claw fingers
+    // Left-drag tracking: only the newest mouse position of each tick is used
+    bool dragging = false;
+    bool dragMoved = false;
+    float dragX = 0, dragY = 0;
 
-    float grabDistance = 10.0f;
+    Histogram& frameSeconds = metrics().histogram("arm_frame_seconds", "Time of one frame of the window loop.",
+                                                  exponentialBuckets(0.001, 2, 12));
+    Gauge& arenaBytes = metrics().gauge("arm_frame_arena_peak_bytes", "Most frame arena bytes one frame has used.");
+    Counter& traceDone = metrics().counter("arm_trajectories_completed_total{kind=\"trace\"}", "Trajectories that ran to their end, by kind.");
+    auto frameStart = std::chrono::steady_clock::now();
 
     while (window.isOpen()) {
+        auto now = std::chrono::steady_clock::now();
+        frameSeconds.observe(std::chrono::duration<double>(now - frameStart).count());
+        frameStart = now;
+        arenaBytes.set(static_cast<double>(frameArena().highWater()));
+        frameArena().reset(); // Scratch of the previous frame
+        tickCommands.clear();
+
         sf::Event event;
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed)
                 window.close();
 
-            // Enter target coordinates in grid squares (relative to center)
-            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P) {
-                std::cout << "Enter new target coordinates (tx ty): ";
-                float x, y;
-                std::cin >> x >> y;
-
-                // Convert from grid units to pixel coordinates
-                tx = px + (x * gridSize); // Move left/right from center
-                ty = py - (y * gridSize); // Move up/down from center (negative Y because screen origin is top-left)
-
-                // Check if the new target is reachable
-                float d = std::sqrt((tx - px) * (tx - px) + (ty - py) * (ty - py));
-                if (d > L1 + L2) {
-                    std::cout << "Target is out of reach! Try again.\n";
-                } else {
-                    std::cout << "New target set at (" << x << ", " << y << ") in grid coordinates\n";
+            if (replay.isOpen()) {
+                // Replay controls: Space pauses, Left/Right jump one keyframe interval
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Space) {
+                    paused = !paused;
                 }
+                if (event.type == sf::Event::KeyPressed
+                    && (event.key.code == sf::Keyboard::Left || event.key.code == sf::Keyboard::Right)) {
+                    uint64_t step = replay.keyframeInterval();
+                    uint64_t tick = telemetry.tick;
+                    tick = event.key.code == sf::Keyboard::Right ? tick + step : (tick > step ? tick - step : 0);
+                    if (replay.seek(tick, telemetry)) restoreTelemetry(telemetry, arm);
+                }
+                continue;
+            }
 
-                // Calculate the new target angles
-                calculateArmAngles(px, py, tx, ty, L1, L2, targetAngle1, targetAngle2, elbowUp);
-
+            // Enter target coordinates in grid squares (relative to center)
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P) {
+                console.prompt(ArmCommand::Type::TargetGrid);
             }
 
             if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
-                int mouseX = event.mouseButton.x;
-                int mouseY = event.mouseButton.y;
-
-                // Calculate the distance from the pivot point
-                float distance = std::sqrt((mouseX - px) * (mouseX - px) + (mouseY - py) * (mouseY - py));
-
-                // Check if the click is within the minimum reach circle
-                float minReach = std::max(0.0f, L1 - L2);
-                if (distance < minReach) {
-                    // If it's inside the minimum reachable area, set the target at the minimum distance
-                    float angle = std::atan2(mouseY - py, mouseX - px);
-                    tx = px + minReach * std::cos(angle);
-                    ty = py + minReach * std::sin(angle);
-                } else {
-                    // Otherwise, set the target to the clicked position
-                    tx = mouseX;
-                    ty = mouseY;
-                }
-
-                std::cout << "New target set at (" << (tx - px) / gridSize << ", " << -(ty - py) / gridSize << ") in grid coordinates\n";
+                // Shift-click moves the claw in a straight line instead of interpolating the joints
+                bool shift = sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) || sf::Keyboard::isKeyPressed(sf::Keyboard::RShift);
+                ArmCommand command;
+                command.type = shift ? ArmCommand::Type::Linear : ArmCommand::Type::Target;
+                command.a = event.mouseButton.x;
+                command.b = event.mouseButton.y;
+                tickCommands.push_back(command);
+                dragging = !shift;
+            }
 
-                // Calculate the new target angles
-                calculateArmAngles(px, py, tx, ty, L1, L2, targetAngle1, targetAngle2, elbowUp);
+            if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
+                dragging = false;
+            }
 
+            if (event.type == sf::Event::MouseMoved && dragging) {
+                dragMoved = true;
+                dragX = event.mouseMove.x;
+                dragY = event.mouseMove.y;
             }
 
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::M) {
-                std::cout << "Enter new length for the upper arm (L1): ";
-                std::cin >> L1; // Get new length for the upper arm
-                std::cout << "Enter new length for the lower arm (L2): ";
-                std::cin >> L2; // Get new length for the lower arm
-
-                // Ensure the lengths are valid
-                if (L1 <= 0 || L2 <= 0) {
-                    std::cout << "Lengths must be positive numbers!" << std::endl;
-                    L1 = 100; // Reset to default if invalid input
-                    L2 = 100;
-                } else {
-                    std::cout << "Updated lengths - L1: " << L1 << ", L2: " << L2 << std::endl;
-                }
+                console.prompt(ArmCommand::Type::Lengths);
             }
 
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::C) {
-                std::cout << "Enter new zero point X: ";
-                std::cin >> px;
-                std::cout << "Enter new zero point Y: ";
-                std::cin >> py;
-
-                if (px < 0 || py < 0) {
-                    std::cout << "Zero point must be positive number!" << std::endl;
-                    px = 400; // Reset to default if invalid input
-                    py = 300;
-                } else {
-                    std::cout << "Updated zero point - Px: " << px << ", Py: " << py << std::endl;
-                }
+                console.prompt(ArmCommand::Type::Pivot);
+            }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::L) {
+                console.prompt(ArmCommand::Type::Linear);
             }
 
             if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Right) {
-                int mouseX = event.mouseButton.x;
-                int mouseY = event.mouseButton.y;
-                itemGrabbed = false;
-                drawItem(mouseX, mouseY);
+                ArmCommand command;
+                command.type = ArmCommand::Type::Item;
+                command.a = event.mouseButton.x;
+                command.b = event.mouseButton.y;
+                tickCommands.push_back(command);
                 // std::cout << items[0].getPosition().x << " " << items[0].getPosition().y << std::endl;
             }
 
 
         }
 
-        // Smoothly interpolate angles towards the target angles
-        currentAngle1 = lerp(currentAngle1, targetAngle1, smoothFactor);
-        currentAngle2 = lerp(currentAngle2, targetAngle2, smoothFactor);
-
-        // Compute joint positions
-        float x2 = px + L1 * std::cos(currentAngle1);
-        float y2 = py + L1 * std::sin(currentAngle1);
-        float x3 = x2 + L2 * std::cos(currentAngle1 + currentAngle2);
-        float y3 = y2 + L2 * std::sin(currentAngle1 + currentAngle2);
-
-        window.clear(sf::Color::White);
-        drawGrid(window, 800, 600, gridSize);
-
-        // Draw robotic arm with smooth transition
-        drawThickLine(window, px, py, x2, y2, sf::Color::Blue, thickness); // Upper arm
-        drawThickLine(window, x2, y2, x3, y3, sf::Color::Red, thickness);  // Lower arm
-        // Draw the claw at the end of the arm (second segment)
-        drawClaw(window, x3, y3, currentAngle1 + currentAngle2, clawLength, clawWidth, sf::Color::Black);
-
-
-        bool holdingItem = false;
-        size_t heldItemIndex = -1;
-        float itemSmoothFactor = 0.1f; // Smoothing factor for item movement
-
-        if (!items.empty()) {
-            sf::Vector2f itemPos = items[0].getPosition();
-            float itemX = itemPos.x + items[0].getRadius();
-            float itemY = itemPos.y + items[0].getRadius();
-            float distToClaw = std::sqrt((itemX - x3) * (itemX - x3) + (itemY - y3) * (itemY - y3));
-
-            if (distToClaw < grabDistance) {
-                if (!itemGrabbed) {
-                    itemGrabbed = true;
-                    grabbedItemOffset.x = itemX - x3;
-                    grabbedItemOffset.y = itemY - y3;
-                }
+        if (replay.isOpen()) {
+            // Show the recorded state instead of simulating
+            if (!paused && replay.next(telemetry)) restoreTelemetry(telemetry, arm);
+        } else {
+            // Coalesce the burst of MouseMoved events into one tracking update
+            if (dragMoved) {
+                ArmCommand command;
+                command.type = ArmCommand::Type::Track;
+                command.a = dragX;
+                command.b = dragY;
+                tickCommands.push_back(command);
+                dragMoved = false;
             }
 
-            if (itemGrabbed) {
-                // Offset the item forward so it's not directly above the claw
-                float offsetDistance = clawLength * 1.0f; // Move item slightly forward
-                float clawTipX = x3 + offsetDistance * std::cos(currentAngle1 + currentAngle2);
-                float clawTipY = y3 + offsetDistance * std::sin(currentAngle1 + currentAngle2);
-
-                items[0].setPosition(clawTipX - items[0].getRadius(), clawTipY - items[0].getRadius());
+            // Jog the claw with the arrow keys or the first joystick
+            float jogX = 0, jogY = 0;
+            if (window.hasFocus()) {
+                jogX = static_cast<float>(sf::Keyboard::isKeyPressed(sf::Keyboard::Right) - sf::Keyboard::isKeyPressed(sf::Keyboard::Left));
+                jogY = static_cast<float>(sf::Keyboard::isKeyPressed(sf::Keyboard::Down) - sf::Keyboard::isKeyPressed(sf::Keyboard::Up));
+            }
+            if (sf::Joystick::isConnected(0)) {
+                float axisX = sf::Joystick::getAxisPosition(0, sf::Joystick::X) / 100.0f;
+                float axisY = sf::Joystick::getAxisPosition(0, sf::Joystick::Y) / 100.0f;
+                if (std::abs(axisX) > 0.15f) jogX += axisX; // Dead zone
+                if (std::abs(axisY) > 0.15f) jogY += axisY;
+            }
+            if (jogX != 0 || jogY != 0) {
+                ArmCommand command;
+                command.type = ArmCommand::Type::Jog;
+                command.a = jogX * params.trackSpeed;
+                command.b = jogY * params.trackSpeed;
+                tickCommands.push_back(command);
             }
 
-        }
+            // Collect console commands typed since the last tick
+            ArmCommand command;
+            while (console.poll(command)) {
+                tickCommands.push_back(command);
+            }
 
+            // Collect the coalesced batch received on the command socket
+            server.poll(tickCommands);
+            server.reportLatency(5.0);
+
+            // Play the traced trajectory one sample per tick
+            if (traceTick < trace.angles.size()) {
+                ArmCommand command;
+                command.type = ArmCommand::Type::Joints;
+                command.a = trace.angles[traceTick].angle1;
+                command.b = trace.angles[traceTick].angle2;
+                tickCommands.push_back(command);
+                if (++traceTick == trace.angles.size()) traceDone.add();
+            }
 
+            if (conveyorEnabled) {
+                tickConveyor(conveyor, arm, params, tickCommands);
+                reportConveyor(conveyor, 60.0);
+            }
 
-        drawJoint(window, x2, y2);
+            // Point-to-point targets for arm 0 go through the coordinator's queue
+            if (coordinate) {
+                for (const ArmCommand& command : tickCommands) {
+                    if (command.type == ArmCommand::Type::Target) submitMove(coordinator, 0, command.a, command.b);
+                }
+                std::erase_if(tickCommands, [](const ArmCommand& command) { return command.type == ArmCommand::Type::Target; });
+                tickCoordinator(coordinator, arms, params);
+                reportCoordinator(coordinator, 60.0);
+            }
 
-        // Draw the minimum reach circle (radius L1 - L2)
-        drawMinReachCircle(window, px, py, L1, L2);
+            if (control.isRunning()) {
+                // Items stay on this thread; everything else moves the arms on the control thread
+                control.snapshot(arms);
+                for (const ArmCommand& command : tickCommands) {
+                    if (command.type == ArmCommand::Type::Item) {
+                        applyCommand(arm, command, params);
+                    } else if (!control.submit(command)) {
+                        logWarning("Control queue full, command dropped");
+                    }
+                }
+                updateGrab(arm, computePose(arm, params.fkTrig), params);
+                control.reportStats(5.0);
+            } else {
+                // Apply commands, move the arms and update the grabbed item
+                tickArms(arms, tickCommands, params, &pool);
+                pool.reportStats(60.0);
+            }
+        }
 
-        // Draw the maximum reach circle (radius L1 + L2)
-        drawMaxReachCircle(window, px, py, L1, L2);
+        // Compute joint positions
+        ArmPose pose = computePose(arm, params.fkTrig);
 
-        drawZeroPoint(window, px, py);
+        publisher.publish(arm, pose.x2, pose.y2, pose.x3, pose.y3);
 
-        for (const auto& item : items) {
-            window.draw(item);
+        if (recorder.isOpen()) {
+            captureTelemetry(arm, telemetry);
+            telemetry.commands = tickCommands;
+            recorder.record(telemetry);
         }
 
+        drawScene(window, arms, params, scene.obstacles(), scene.obstacleCount(), sceneItems, width, height);
+        if (conveyorEnabled) drawConveyor(window, conveyor);
+        if (traceLine.getVertexCount() > 0) submitVertices(window, traceLine);
         window.display();
     }
 
-    return 0;
+    control.stop();
+    console.stop();
+    bool recorded = recorder.close();
+    exporter.stop();
+    return recorded ? 0 : 1;
 }
@@ -0,0 +1,304 @@
+// Offline batch inverse kinematics.
+//
+// Usage: batch_ik [options] <input> <output>
+//   --L1 <len> --L2 <len>     link lengths (default 100 100)
+//   --pivot <px> <py>         pivot point (default 0 0)
+//   --elbow up|down           configuration to report (default up)
+//   --in csv|bin              input format (default: bin for *.bin, else csv)
+//   --out csv|bin             output format (default: bin for *.bin, else csv)
+//   --threads <n>             worker threads (default: hardware concurrency)
+//   --solver float|double|lanes
+//                             float: the simulator's solver (default); double:
+//                             solved in double and rounded; lanes: FastMath
+//                             solver, FloatLanes::kWidth targets per call
+//
+// CSV input has one "x,y" (or "x y") target per line; binary input is packed
+// float32 x/y pairs. The input is memory-mapped and split into one chunk per
+// thread; each chunk is solved and formatted independently and the chunks are
+// written in order. Output rows are angle1, angle2, reachable (binary: two
+// float32 and one uint32 per target). Throughput is reported on stderr.
+//
+// A first CSV line that is not two numbers is taken as a header and blank
+// lines are skipped. Any other line that is not two numbers gets an error row
+// (nan angles, reachable -1; binary 0xFFFFFFFF) so output rows stay aligned
+// with input rows, and the tool exits with status 2.
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../Kinematics.h"
+
+namespace {
+
+enum class Solver { Float, Double, Lanes };
+
+struct Options {
+    float L1 = 100, L2 = 100;
+    float px = 0, py = 0;
+    bool elbowUp = true;
+    bool binaryIn = false, binaryOut = false;
+    Solver solver = Solver::Float;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+    std::vector<char> output;
+    size_t targets = 0;
+    size_t unreachable = 0;
+    size_t malformed = 0;
+    bool header = false; // The chunk starts the file, so its first line may be a header
+    FloatLanes pendingX, pendingY; // Targets waiting for a full lanes batch
+    int pending = 0;
+};
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void appendBinary(std::vector<char>& out, float angle1, float angle2, uint32_t reachable) {
+    size_t at = out.size();
+    out.resize(at + 12);
+    std::memcpy(out.data() + at, &angle1, 4);
+    std::memcpy(out.data() + at + 4, &angle2, 4);
+    std::memcpy(out.data() + at + 8, &reachable, 4);
+}
+
+void appendCsv(std::vector<char>& out, float angle1, float angle2, int reachable) {
+    char line[64];
+    char* cursor = std::to_chars(line, line + sizeof(line), angle1).ptr;
+    *cursor++ = ',';
+    cursor = std::to_chars(cursor, line + sizeof(line), angle2).ptr;
+    *cursor++ = ',';
+    if (reachable < 0) *cursor++ = '-';
+    *cursor++ = reachable != 0 ? '1' : '0';
+    *cursor++ = '\n';
+    out.insert(out.end(), line, cursor);
+}
+
+void appendSolution(const Options& options, const ArmSolution& solution, bool reachable, Chunk& chunk) {
+    ++chunk.targets;
+    if (!reachable) ++chunk.unreachable;
+    if (options.binaryOut) {
+        appendBinary(chunk.output, solution.angle1, solution.angle2, reachable ? 1u : 0u);
+    } else {
+        appendCsv(chunk.output, solution.angle1, solution.angle2, reachable ? 1 : 0);
+    }
+}
+
+// Solves the pending targets of the lanes solver; unused lanes are solved but not written
+void flushLanes(const Options& options, Chunk& chunk) {
+    if (chunk.pending == 0) return;
+    BasicArmSolution<FloatLanes> up, down;
+    LaneMask reachable = solveArmKernel<FloatLanes>(chunk.pendingX - options.px, chunk.pendingY - options.py,
+                                                    options.L1, options.L2, up, down);
+    const BasicArmSolution<FloatLanes>& solution = options.elbowUp ? up : down;
+    for (int k = 0; k < chunk.pending; ++k) {
+        bool ok = reachable.lane[k] != 0;
+        ArmSolution angles{0, 0};
+        if (ok) angles = {solution.angle1.lane[k], solution.angle2.lane[k]};
+        appendSolution(options, angles, ok, chunk);
+    }
+    chunk.pending = 0;
+}
+
+void solveTarget(const Options& options, float x, float y, Chunk& chunk) {
+    if (options.solver == Solver::Lanes) {
+        chunk.pendingX.lane[chunk.pending] = x;
+        chunk.pendingY.lane[chunk.pending] = y;
+        if (++chunk.pending == FloatLanes::kWidth) flushLanes(options, chunk);
+        return;
+    }
+
+    ArmSolution up{0, 0}, down{0, 0};
+    bool reachable;
+    if (options.solver == Solver::Double) {
+        BasicArmSolution<double> u{0, 0}, d{0, 0};
+        reachable = solveArmConfigurations<double>(options.px, options.py, x, y, options.L1, options.L2, u, d) == IkResult::Ok;
+        up = {static_cast<float>(u.angle1), static_cast<float>(u.angle2)};
+        down = {static_cast<float>(d.angle1), static_cast<float>(d.angle2)};
+    } else {
+        reachable = solveArmConfigurations(options.px, options.py, x, y, options.L1, options.L2, up, down) == IkResult::Ok;
+    }
+    appendSolution(options, options.elbowUp ? up : down, reachable, chunk);
+}
+
+void solveBinaryChunk(const Options& options, Chunk& chunk) {
+    size_t count = static_cast<size_t>(chunk.end - chunk.begin) / 8;
+    chunk.output.reserve(count * (options.binaryOut ? 12 : 24));
+    for (size_t i = 0; i < count; ++i) {
+        float xy[2];
+        std::memcpy(xy, chunk.begin + 8 * i, 8);
+        solveTarget(options, xy[0], xy[1], chunk);
+    }
+    flushLanes(options, chunk);
+}
+
+// Error row for an input line that is not a target, in the output position of that line
+void appendMalformed(const Options& options, Chunk& chunk) {
+    flushLanes(options, chunk); // Rows of earlier targets come first
+    ++chunk.malformed;
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    if (options.binaryOut) appendBinary(chunk.output, nan, nan, 0xFFFFFFFFu);
+    else appendCsv(chunk.output, nan, nan, -1);
+}
+
+void solveCsvChunk(const Options& options, Chunk& chunk) {
+    chunk.output.reserve(static_cast<size_t>(chunk.end - chunk.begin) * 2);
+    const char* cursor = chunk.begin;
+    bool firstLine = chunk.header;
+    while (cursor < chunk.end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', chunk.end - cursor));
+        if (!lineEnd) lineEnd = chunk.end;
+
+        const char* p = cursor;
+        while (p < lineEnd && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        bool blank = p == lineEnd;
+        float x, y;
+        bool parsed = false;
+        auto first = std::from_chars(p, lineEnd, x);
+        if (first.ec == std::errc() && !blank) {
+            p = first.ptr;
+            while (p < lineEnd && (*p == ',' || *p == ' ' || *p == '\t')) ++p;
+            auto second = std::from_chars(p, lineEnd, y);
+            parsed = second.ec == std::errc();
+        }
+        if (parsed) solveTarget(options, x, y, chunk);
+        else if (!blank && !firstLine) appendMalformed(options, chunk);
+        firstLine = false;
+        cursor = lineEnd + 1;
+    }
+    flushLanes(options, chunk);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string inFormat, outFormat;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--L1" && i + 1 < argc) options.L1 = std::stof(argv[++i]);
+        else if (arg == "--L2" && i + 1 < argc) options.L2 = std::stof(argv[++i]);
+        else if (arg == "--pivot" && i + 2 < argc) {
+            options.px = std::stof(argv[++i]);
+            options.py = std::stof(argv[++i]);
+        } else if (arg == "--elbow" && i + 1 < argc) options.elbowUp = std::string(argv[++i]) != "down";
+        else if (arg == "--in" && i + 1 < argc) inFormat = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) outFormat = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) options.threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--solver" && i + 1 < argc) {
+            std::string solver = argv[++i];
+            if (solver == "double") options.solver = Solver::Double;
+            else if (solver == "lanes") options.solver = Solver::Lanes;
+            else options.solver = Solver::Float;
+        }
+        else paths.push_back(arg);
+    }
+    if (paths.size() != 2) {
+        std::cerr << "Usage: " << argv[0] << " [--L1 len] [--L2 len] [--pivot px py] [--elbow up|down]"
+                  << " [--in csv|bin] [--out csv|bin] [--threads n] [--solver float|double|lanes] <input> <output>\n";
+        return 1;
+    }
+    options.binaryIn = inFormat.empty() ? endsWith(paths[0], ".bin") : inFormat == "bin";
+    options.binaryOut = outFormat.empty() ? endsWith(paths[1], ".bin") : outFormat == "bin";
+
+    int fd = ::open(paths[0].c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) < 0) {
+        std::cerr << "Cannot open " << paths[0] << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    const char* data = "";
+    if (size > 0) {
+        void* memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (memory == MAP_FAILED) {
+            std::cerr << "Cannot map " << paths[0] << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        ::madvise(memory, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(memory);
+    }
+    ::close(fd);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Split the input into one chunk per thread on record boundaries
+    std::vector<Chunk> chunks(options.threads);
+    const char* cursor = data;
+    const char* end = data + (options.binaryIn ? size - size % 8 : size);
+    for (unsigned i = 0; i < options.threads; ++i) {
+        const char* chunkEnd = i + 1 == options.threads ? end : data + size / options.threads * (i + 1);
+        if (chunkEnd < cursor) chunkEnd = cursor;
+        if (options.binaryIn) {
+            chunkEnd = data + static_cast<size_t>(chunkEnd - data) / 8 * 8;
+        } else if (chunkEnd < end) {
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        chunks[i].begin = cursor;
+        chunks[i].end = chunkEnd;
+        chunks[i].header = i == 0;
+        cursor = chunkEnd;
+    }
+
+    std::vector<std::thread> workers;
+    for (Chunk& chunk : chunks) {
+        workers.emplace_back([&options, &chunk] {
+            if (options.binaryIn) solveBinaryChunk(options, chunk);
+            else solveCsvChunk(options, chunk);
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    auto solved = std::chrono::steady_clock::now();
+
+    FILE* out = std::fopen(paths[1].c_str(), "wb");
+    if (!out) {
+        std::cerr << "Cannot create " << paths[1] << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    std::setvbuf(out, nullptr, _IOFBF, 1 << 20);
+    size_t targets = 0, unreachable = 0, malformed = 0;
+    bool written = true;
+    for (const Chunk& chunk : chunks) {
+        written = written && std::fwrite(chunk.output.data(), 1, chunk.output.size(), out) == chunk.output.size();
+        targets += chunk.targets;
+        unreachable += chunk.unreachable;
+        malformed += chunk.malformed;
+    }
+    written = std::fclose(out) == 0 && written;
+    if (!written) {
+        std::cerr << "Failed to write " << paths[1] << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    auto done = std::chrono::steady_clock::now();
+    double solveSeconds = std::chrono::duration<double>(solved - start).count();
+    double totalSeconds = std::chrono::duration<double>(done - start).count();
+    std::cerr << targets << " targets (" << unreachable << " unreachable) on " << options.threads << " threads: "
+              << (solveSeconds > 0 ? targets / solveSeconds : 0) << " targets/s solve, "
+              << (totalSeconds > 0 ? targets / totalSeconds : 0) << " targets/s including output\n";
+    if (malformed > 0) {
+        std::cerr << malformed << " malformed input lines (error rows in the output)\n";
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+// Motor sizing study for the torque-driven arm dynamics.
+//
+// Usage: motor_sizing [options]
+//   --arms <n>                arms simulated together (default 4096)
+//   --moves <n>               moves per arm (default 8)
+//   --L1 <len> --L2 <len>     link lengths in pixels (default 100 100)
+//   --payload <kg>            point mass at the end effector (default 0)
+//   --torque1 <a,b,...>       shoulder torque limits to compare, N m (default 10,20,30,40)
+//   --torque2 <a,b,...>       elbow torque limits to compare, N m (default 5,10)
+//   --duration <s>            duration of each move (default 1)
+//   --law pd|pid|ct           joint control law (default pd)
+//
+// Every combination of shoulder and elbow limit gets an equal share of one
+// batch of arms. All arms move in lockstep through random point-to-point moves
+// along a minimum-jerk joint profile, followed by a settle window, stepped at
+// 1 kHz with servoTorques and stepDynamics. One line is printed per
+// combination: the share of moves that settled on target, the worst and RMS
+// tracking error during the moves and the share of ticks a motor was
+// saturated. Throughput is reported on stderr.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../Dynamics.h"
+
+namespace {
+
+constexpr float kSettleSeconds = 0.2f;    // Window after each move before it is judged
+constexpr float kSettleTolerance = 0.01f; // Joint error (rad) that counts as on target
+
+struct ArmStats {
+    uint64_t moves = 0, settled = 0;
+    uint64_t ticks = 0, saturatedTicks = 0;
+    double errorSquares = 0;
+    float maxError = 0;
+};
+
+std::vector<float> parseList(const std::string& text) {
+    std::vector<float> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(std::stof(item));
+    }
+    return values;
+}
+
+// Minimum-jerk blend from 0 to 1 over t in [0, 1], and its derivative
+float minimumJerk(float t) {
+    t = std::clamp(t, 0.0f, 1.0f);
+    return t * t * t * (10 - 15 * t + 6 * t * t);
+}
+
+float minimumJerkRate(float t) {
+    t = std::clamp(t, 0.0f, 1.0f);
+    return 30 * t * t * (1 - t) * (1 - t);
+}
+
+float minimumJerkAcceleration(float t) {
+    t = std::clamp(t, 0.0f, 1.0f);
+    return 60 * t * (1 - t) * (1 - 2 * t);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t armCount = 4096;
+    int moves = 8;
+    float L1 = 100, L2 = 100;
+    float duration = 1.0f;
+    std::vector<float> torques1{10, 20, 30, 40}, torques2{5, 10};
+    DynamicsParams params;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--arms" && i + 1 < argc) armCount = std::stoul(argv[++i]);
+        else if (arg == "--moves" && i + 1 < argc) moves = std::stoi(argv[++i]);
+        else if (arg == "--L1" && i + 1 < argc) L1 = std::stof(argv[++i]);
+        else if (arg == "--L2" && i + 1 < argc) L2 = std::stof(argv[++i]);
+        else if (arg == "--payload" && i + 1 < argc) params.payload = std::stof(argv[++i]);
+        else if (arg == "--torque1" && i + 1 < argc) torques1 = parseList(argv[++i]);
+        else if (arg == "--torque2" && i + 1 < argc) torques2 = parseList(argv[++i]);
+        else if (arg == "--duration" && i + 1 < argc) duration = std::stof(argv[++i]);
+        else if (arg == "--law" && i + 1 < argc) {
+            std::string law = argv[++i];
+            params.law = law == "pid" ? ControlLaw::Pid : law == "ct" ? ControlLaw::ComputedTorque : ControlLaw::Pd;
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--arms n] [--moves n] [--L1 len] [--L2 len] [--payload kg]"
+                      << " [--torque1 a,b,...] [--torque2 a,b,...] [--duration s] [--law pd|pid|ct]\n";
+            return 1;
+        }
+    }
+    size_t combinations = torques1.size() * torques2.size();
+    if (combinations == 0 || armCount < combinations || moves <= 0 || duration <= 0) {
+        std::cerr << "Need at least one torque limit per joint, one arm per combination and a positive move count and duration\n";
+        return 1;
+    }
+
+    // Arm i uses combination i % combinations
+    DynamicsBatch batch;
+    batch.resize(armCount);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> shoulder(-3.14159265f, 3.14159265f), elbow(-2.6f, 2.6f);
+    for (size_t i = 0; i < armCount; ++i) {
+        size_t combination = i % combinations;
+        batch.L1[i] = L1 * params.metersPerPixel;
+        batch.L2[i] = L2 * params.metersPerPixel;
+        batch.maxTorque1[i] = torques1[combination / torques2.size()];
+        batch.maxTorque2[i] = torques2[combination % torques2.size()];
+        batch.angle1[i] = batch.setpoint1[i] = shoulder(rng);
+        batch.angle2[i] = batch.setpoint2[i] = elbow(rng);
+    }
+
+    std::vector<float> from1(armCount), from2(armCount), to1(armCount), to2(armCount);
+    std::vector<ArmStats> stats(armCount);
+    int moveTicks = static_cast<int>(std::lround(duration / params.dt));
+    int settleTicks = static_cast<int>(std::lround(kSettleSeconds / params.dt));
+
+    auto start = std::chrono::steady_clock::now();
+    for (int move = 0; move < moves; ++move) {
+        for (size_t i = 0; i < armCount; ++i) {
+            from1[i] = batch.setpoint1[i];
+            from2[i] = batch.setpoint2[i];
+            to1[i] = shoulder(rng);
+            to2[i] = elbow(rng);
+        }
+
+        for (int tick = 0; tick < moveTicks + settleTicks; ++tick) {
+            float t = static_cast<float>(tick + 1) / static_cast<float>(moveTicks);
+            float blend = minimumJerk(t);
+            float rate = minimumJerkRate(t) / duration;
+            float acceleration = minimumJerkAcceleration(t) / (duration * duration);
+            for (size_t i = 0; i < armCount; ++i) {
+                batch.setpoint1[i] = from1[i] + (to1[i] - from1[i]) * blend;
+                batch.setpoint2[i] = from2[i] + (to2[i] - from2[i]) * blend;
+                batch.setpointVelocity1[i] = (to1[i] - from1[i]) * rate;
+                batch.setpointVelocity2[i] = (to2[i] - from2[i]) * rate;
+                batch.setpointAcceleration1[i] = (to1[i] - from1[i]) * acceleration;
+                batch.setpointAcceleration2[i] = (to2[i] - from2[i]) * acceleration;
+            }
+            servoTorques(batch, params, 0, armCount);
+            stepDynamics(batch, params, 0, armCount);
+
+            for (size_t i = 0; i < armCount; ++i) {
+                ArmStats& arm = stats[i];
+                float error = std::max(std::abs(batch.setpoint1[i] - batch.angle1[i]), std::abs(batch.setpoint2[i] - batch.angle2[i]));
+                arm.errorSquares += static_cast<double>(error) * error;
+                arm.maxError = std::max(arm.maxError, error);
+                ++arm.ticks;
+                if (std::abs(batch.torque1[i]) >= batch.maxTorque1[i] || std::abs(batch.torque2[i]) >= batch.maxTorque2[i]) {
+                    ++arm.saturatedTicks;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < armCount; ++i) {
+            ++stats[i].moves;
+            if (std::abs(to1[i] - batch.angle1[i]) < kSettleTolerance && std::abs(to2[i] - batch.angle2[i]) < kSettleTolerance) {
+                ++stats[i].settled;
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // key value lines in a fixed order, like the frame benchmark
+    for (size_t combination = 0; combination < combinations; ++combination) {
+        ArmStats total;
+        for (size_t i = combination; i < armCount; i += combinations) {
+            total.moves += stats[i].moves;
+            total.settled += stats[i].settled;
+            total.ticks += stats[i].ticks;
+            total.saturatedTicks += stats[i].saturatedTicks;
+            total.errorSquares += stats[i].errorSquares;
+            total.maxError = std::max(total.maxError, stats[i].maxError);
+        }
+        std::printf("torque1 %g torque2 %g moves %llu settled_pct %.2f max_error_rad %.4f rms_error_rad %.4f saturated_pct %.2f\n",
+                    torques1[combination / torques2.size()], torques2[combination % torques2.size()],
+                    static_cast<unsigned long long>(total.moves),
+                    100.0 * static_cast<double>(total.settled) / static_cast<double>(total.moves),
+                    total.maxError, std::sqrt(total.errorSquares / static_cast<double>(total.ticks)),
+                    100.0 * static_cast<double>(total.saturatedTicks) / static_cast<double>(total.ticks));
+    }
+
+    double simulated = static_cast<double>(armCount) * moves;
+    std::cerr << simulated << " moves (" << simulated * (moveTicks + settleTicks) << " arm steps) in " << seconds << " s: "
+              << simulated / seconds << " moves/s\n";
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Converts a text scene description into the binary, mmap-able scene format.
+//
+// Usage: scene_convert <scene.txt> <scene.arms>
+//
+// One record per line, '#' starts a comment:
+//   grid <size>
+//   window <width> <height>
+//   arm <px> <py> <L1> <L2> [<min1> <max1> <min2> <max2>]   joint limits in degrees
+//   obstacle <x> <y> <radius>
+//   item <x> <y>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../Scene.h"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <scene.txt> <scene.arms>\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "Cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    SceneHeader header{};
+    header.gridSize = 10;
+    header.width = 800;
+    header.height = 600;
+    std::vector<SceneArm> arms;
+    std::vector<SceneObstacle> obstacles;
+    std::vector<SceneItem> items;
+
+    const float degrees = static_cast<float>(M_PI / 180.0);
+    const float unlimited = std::numeric_limits<float>::infinity();
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string kind;
+        if (!(fields >> kind)) continue;
+
+        bool ok;
+        if (kind == "grid") {
+            ok = static_cast<bool>(fields >> header.gridSize);
+        } else if (kind == "window") {
+            ok = static_cast<bool>(fields >> header.width >> header.height);
+        } else if (kind == "arm") {
+            SceneArm arm{};
+            ok = static_cast<bool>(fields >> arm.px >> arm.py >> arm.L1 >> arm.L2) && arm.L1 > 0 && arm.L2 > 0;
+            float limits[4];
+            if (ok && fields >> limits[0] >> limits[1] >> limits[2] >> limits[3]) {
+                arm.minAngle1 = limits[0] * degrees;
+                arm.maxAngle1 = limits[1] * degrees;
+                arm.minAngle2 = limits[2] * degrees;
+                arm.maxAngle2 = limits[3] * degrees;
+            } else {
+                arm.minAngle1 = arm.minAngle2 = -unlimited;
+                arm.maxAngle1 = arm.maxAngle2 = unlimited;
+            }
+            arms.push_back(arm);
+        } else if (kind == "obstacle") {
+            SceneObstacle obstacle{};
+            ok = static_cast<bool>(fields >> obstacle.x >> obstacle.y >> obstacle.radius);
+            obstacles.push_back(obstacle);
+        } else if (kind == "item") {
+            SceneItem item{};
+            ok = static_cast<bool>(fields >> item.x >> item.y);
+            items.push_back(item);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << argv[1] << ":" << lineNumber << ": invalid record: " << line << "\n";
+            return 1;
+        }
+    }
+
+    if (!writeScene(argv[2], header, arms, obstacles, items)) return 1;
+    std::cout << "Wrote " << argv[2] << ": " << arms.size() << " arms, " << obstacles.size() << " obstacles, "
+              << items.size() << " items\n";
+    return 0;
+}